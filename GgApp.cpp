@@ -75,6 +75,11 @@ GgApp::GgApp(int major, int minor)
 #endif
   }
 
+#if defined(DEBUG) && !defined(GL_GLES_PROTOTYPES)
+  // デバッグビルドではデバッグ出力が使えるコンテキストを作る
+  glfwWindowHint(GLFW_OPENGL_DEBUG_CONTEXT, GL_TRUE);
+#endif
+
 #if defined(GG_USE_OCULUS_RIFT)
   // Oculus Rift では SRGB でレンダリングする
   glfwWindowHint(GLFW_SRGB_CAPABLE, GL_TRUE);
@@ -194,20 +199,20 @@ void GgApp::Window::keyboard(GLFWwindow* window, int key, int scancode, int acti
     if (instance->keyboardFunc) (*instance->keyboardFunc)(instance, key, scancode, action, mods);
 
     // 対象のユーザインタフェース
-    auto& current_if{ instance->interfaceData[instance->interfaceNo] };
+    auto& current_if{ instance->getCurrentInterface() };
 
     switch (key)
     {
     case GLFW_KEY_HOME:
 
       // トラックボールを初期化する
-      instance->resetRotation();
+      for (auto& tb : current_if.rotation) tb.reset();
       [[fallthrough]];
 
     case GLFW_KEY_END:
 
       // 平行移動量を初期化する
-      instance->resetTranslation();
+      current_if.resetTranslation();
       break;
 
     case GLFW_KEY_UP:
@@ -289,7 +294,7 @@ void GgApp::Window::mouse(GLFWwindow* window, int button, int action, int mods)
     if (instance->mouseFunc) (*instance->mouseFunc)(instance, button, action, mods);
 
     // 対象のユーザインタフェース
-    auto& current_if{ instance->interfaceData[instance->interfaceNo] };
+    auto& current_if{ instance->getCurrentInterface() };
 
     // マウスの現在位置を得る
     const auto x{ current_if.mouse[0] };
@@ -330,7 +335,7 @@ void GgApp::Window::wheel(GLFWwindow* window, double x, double y)
     if (instance->wheelFunc) (*instance->wheelFunc)(instance, x, y);
 
     // 対象のユーザインタフェース
-    auto& current_if{ instance->interfaceData[instance->interfaceNo] };
+    auto& current_if{ instance->getCurrentInterface() };
 
     // マウスホイールの回転量の保存
     current_if.wheel[0] += static_cast<GLfloat>(x);
@@ -351,11 +356,22 @@ GgApp::Window::Window(const std::string& title, int width, int height, int fulls
   fboSize{ width, height },
 #if defined(IMGUI_VERSION)
   menubarHeight{ 0 },
+  imguiVisible{ true },
+  imguiFrame{ false },
+  imguiOwner{ false },
 #endif
   aspect{ 1.0f },
   velocity{ 1.0f, 1.0f, 0.1f },
   status{ false },
-  interfaceNo{ 0 },
+  interfaceBuffer{ std::make_unique<InterfaceBuffer>() },
+  autoAcquire{ true },
+  presentState{ std::make_unique<PresentState>() },
+  swapInterval{ 1.0 / 60.0 },
+  swapTime{ std::chrono::steady_clock::now() },
+  inputTime{ swapTime },
+  idleMode{ false },
+  idleInterval{ 1.0 },
+  idleFrames{ 0 },
   userPointer{ nullptr },
   resizeFunc{ nullptr },
   keyboardFunc{ nullptr },
@@ -412,7 +428,7 @@ GgApp::Window::Window(const std::string& title, int width, int height, int fulls
   glfwSetFramebufferSizeCallback(window, resize);
 
   // 垂直同期タイミングに合わせる
-  glfwSwapInterval(1);
+  setSwapMode(VSync);
 
   // 実際のフレームバッファのサイズを取得する
   glfwGetFramebufferSize(window, &width, &height);
@@ -427,8 +443,12 @@ GgApp::Window::Window(const std::string& title, int width, int height, int fulls
   {
     // Setup Platform/Renderer bindings
     ImGui_ImplGlfw_InitForOpenGL(window, true);
+    imguiOwner = true;
     ImGui_ImplOpenGL3_Init(nullptr);
 
+    // 描画データが変わらなければ前のフレームで転送した頂点を使い回す
+    ImGui_ImplOpenGL3_SetRetainedDrawData(true);
+
     // ImGui のスタイルを設定する
     auto& io{ ImGui::GetIO() };
     io.ConfigFlags |= ImGuiConfigFlags_NavEnableKeyboard;
@@ -455,69 +475,295 @@ GgApp::Window::Window(const std::string& title, int width, int height, int fulls
 //
 GgApp::Window::operator bool()
 {
+  // 描画し直す必要がなければ
+  if (idleMode && idleFrames <= 0 && !interfaceBuffer->invalid.exchange(false, std::memory_order_acq_rel))
+  {
+    // 前のフレームから idleInterval が経過するまでイベントを待つ
+    const auto elapsed{ std::chrono::duration<double>(std::chrono::steady_clock::now() - inputTime).count() };
+    if (elapsed < idleInterval) glfwWaitEventsTimeout(idleInterval - elapsed);
+
+    // 待機を終えたら ImGui の表示が落ち着くまで続けて描画する
+    idleFrames = 3;
+  }
+  if (idleFrames > 0) --idleFrames;
+
   // イベントを取り出す
   glfwPollEvents();
 
+  // 取り出したイベントを処理する
+  return update();
+}
+
+//
+// 取り出したイベントを処理してループを継続すべきかどうか調べる
+//
+bool GgApp::Window::update()
+{
+  // イベントを取り出した時刻を記録する
+  inputTime = std::chrono::steady_clock::now();
+
   // ウィンドウを閉じるべきなら false を返す
   if (shouldClose()) return false;
 
+  // 読み手から要求された初期化を行う
+  const auto request{ interfaceBuffer->request.exchange(0u, std::memory_order_acquire) };
+  for (std::size_t i = 0; i < interfaceData.size(); ++i)
+  {
+    if (request & (1u << (i * 2))) for (auto& tb : interfaceData[i].rotation) tb.reset();
+    if (request & (2u << (i * 2))) interfaceData[i].resetTranslation();
+  }
+
   // 対象のユーザインタフェース
-  auto& current_if{ interfaceData[interfaceNo] };
+  auto& current_if{ getCurrentInterface() };
 
 #if defined(IMGUI_VERSION)
-  // ImGui の新規フレームを作成する
-  ImGui_ImplOpenGL3_NewFrame();
-  ImGui_ImplGlfw_NewFrame();
-  ImGui::NewFrame();
+  // ImGui の状態
+  ImGuiIO& io{ ImGui::GetIO() };
 
-  // ImGui の状態を取り出す
-  const ImGuiIO& io{ ImGui::GetIO() };
+  // ImGui を結び付けたウィンドウで ImGui を使うなら
+  if (imguiOwner && imguiVisible)
+  {
+    // 省略していたフレームの間に離したキーやボタンが押されたままにならないようにする
+    if (!imguiFrame)
+    {
+      io.ClearInputKeys();
+      io.ClearInputMouse();
+    }
 
-  // ImGui がマウスを使うときは Window クラスのマウス位置を更新しない
-  if (io.WantCaptureMouse) return true;
+    // ImGui の新規フレームを作成する
+    ImGui_ImplOpenGL3_NewFrame();
+    ImGui_ImplGlfw_NewFrame();
+    ImGui::NewFrame();
+  }
+  else if (imguiOwner)
+  {
+    // ImGui に届いたイベントを捨てて, ImGui がマウスやキーボードを使っていないことにする
+    io.ClearEventsQueue();
+    io.WantCaptureMouse = io.WantCaptureKeyboard = false;
+  }
 
-  // マウスの位置を更新する
-  current_if.mouse = std::array<GLfloat, 2>{ io.MousePos.x, io.MousePos.y };
+  // ImGui を結び付けていないウィンドウでは ImGui のフレームを作成しない
+  imguiFrame = imguiOwner && imguiVisible;
+
+  // ImGui がマウスを使うときは Window クラスのマウス位置を更新しない
+  const bool updateMouse{ !imguiOwner || !io.WantCaptureMouse };
 #else
+  // マウスの位置は常に更新する
+  const bool updateMouse{ true };
+#endif
+
   // マウスの現在位置を調べる
   double x, y;
   glfwGetCursorPos(window, &x, &y);
+  const std::array<GLfloat, 2> position{ static_cast<GLfloat>(x), static_cast<GLfloat>(y) };
 
-  // マウスの位置を更新する
-  current_if.mouse = std::array<GLfloat, 2>{ static_cast<GLfloat>(x), static_cast<GLfloat>(y) };
-#endif
-
-  // マウスドラッグ
-  for (int button = GLFW_MOUSE_BUTTON_1; button < GLFW_MOUSE_BUTTON_1 + GG_BUTTON_COUNT; ++button)
+  if (updateMouse)
   {
-    // マウスボタンを押していたら
-    if (status[button])
+    // マウスの位置を更新する
+    current_if.mouse = position;
+
+    // マウスドラッグ
+    for (int button = GLFW_MOUSE_BUTTON_1; button < GLFW_MOUSE_BUTTON_1 + GG_BUTTON_COUNT; ++button)
     {
-      // 現在位置と平行移動量を更新する
-      current_if.calcTranslation(button, velocity);
+      // マウスボタンを押していたら
+      if (status[button])
+      {
+        // 現在位置と平行移動量を更新する
+        current_if.calcTranslation(button, velocity);
+      }
     }
   }
 
+  // スナップショットを公開する
+  publishInput();
+
+  // 同じスレッドで描画するならスナップショットを取得する
+  if (autoAcquire) acquireInput();
+
+  return true;
+}
+
+//
+// ヒューマンインタフェースデバイスのデータのスナップショットを公開する
+//
+void GgApp::Window::publishInput()
+{
+  auto& b{ *interfaceBuffer };
+
+  // 書き手の持つスナップショットに現在のデータを複製する
+  auto& snapshot{ b.snapshot[b.back] };
+  snapshot.version = ++b.version;
+  snapshot.data = interfaceData;
+
+  // 最新のスナップショットと入れ替えて, 古い方を次の書き込み先にする
+  b.back = static_cast<int>(b.latest.exchange(static_cast<unsigned int>(b.back) | InterfaceBuffer::fresh,
+    std::memory_order_acq_rel) & 3u);
+
+  // 最後にタイプしたキーは公開したら消す
+  for (auto& i : interfaceData) i.lastKey = 0;
+}
+
+//
+// ヒューマンインタフェースデバイスのデータの最新のスナップショットを取得する
+//
+bool GgApp::Window::acquireInput()
+{
+  auto& b{ *interfaceBuffer };
+
+  // 新しいスナップショットがなければ何もしない
+  if (!(b.latest.load(std::memory_order_acquire) & InterfaceBuffer::fresh)) return false;
+
+  // まだ読んでいないキーを控えておく
+  std::array<int, GG_INTERFACE_COUNT> lastKey;
+  for (std::size_t i = 0; i < lastKey.size(); ++i) lastKey[i] = b.snapshot[b.front].data[i].lastKey;
+
+  // 参照しているスナップショットと最新のスナップショットを入れ替える
+  b.front = static_cast<int>(b.latest.exchange(static_cast<unsigned int>(b.front),
+    std::memory_order_acq_rel) & 3u);
+
+  // 新しいスナップショットでキーがタイプされていなければ読んでいないキーを引き継ぐ
+  for (std::size_t i = 0; i < lastKey.size(); ++i)
+  {
+    auto& key{ b.snapshot[b.front].data[i].lastKey };
+    if (key == 0) key = lastKey[i];
+  }
+
   return true;
 }
 
 //
 // カラーバッファを入れ替える
 //
-void GgApp::Window::swapBuffers() const
+void GgApp::Window::swapBuffers()
 {
 #if defined(IMGUI_VERSION)
-  // ImGui の描画データがあればフレームをレンダリングする
-  ImGui::Render();
-  ImDrawData* data{ ImGui::GetDrawData() };
-  if (data) ImGui_ImplOpenGL3_RenderDrawData(data);
+  // ImGui のフレームを作成していて描画データがあればフレームをレンダリングする
+  if (imguiFrame)
+  {
+    GG_PROFILE_SCOPE("ImGui");
+    ImGui::Render();
+    ImDrawData* data{ ImGui::GetDrawData() };
+    if (data) ImGui_ImplOpenGL3_RenderDrawData(data);
+  }
 #endif
 
+  // フレームを表示する
+  present(inputTime);
+}
+
+//
+// 描画したフレームを表示する
+//
+void GgApp::Window::present(std::chrono::steady_clock::time_point input)
+{
   // エラーチェック
   ggError();
 
-  // カラーバッファを入れ替える
-  glfwSwapBuffers(window);
+  // 要求されたフレームの表示間隔の制御方法を設定する
+  applySwapMode();
+
+  // フレームレートを制限するなら
+  if (presentState->swapMode.load(std::memory_order_relaxed) == Capped)
+  {
+    // 次のフレームを表示する時刻
+    const auto deadline{ swapTime + std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+      std::chrono::duration<double>(swapInterval)) };
+
+    // スリープの精度を見込んで少し手前まで眠り, 残りはスピンして待つ
+    constexpr std::chrono::milliseconds margin{ 2 };
+    if (deadline - std::chrono::steady_clock::now() > margin) std::this_thread::sleep_until(deadline - margin);
+    while (std::chrono::steady_clock::now() < deadline) std::this_thread::yield();
+  }
+
+  {
+    // カラーバッファを入れ替える
+    GG_PROFILE_SCOPE("SwapBuffers");
+    glfwSwapBuffers(window);
+  }
+
+  // フレームの表示間隔を記録する
+  const auto now{ std::chrono::steady_clock::now() };
+  const auto frameTime{ std::chrono::duration<double>(now - swapTime).count() };
+  swapTime = now;
+  presentState->frameTime.store(frameTime, std::memory_order_relaxed);
+  presentState->histogram[std::min(static_cast<int>(frameTime / histogramStep), histogramSize - 1)]
+    .fetch_add(1, std::memory_order_relaxed);
+
+  // このフレームの描画が完了した時刻を記録するクエリを発行する
+  GLuint query;
+  glGenQueries(1, &query);
+  glQueryCounter(query, GL_TIMESTAMP);
+  latencyQuery.emplace_back(query, input);
+
+  // GPU のタイムスタンプと CPU の時刻の差を求める
+  GLint64 timestamp;
+  glGetInteger64v(GL_TIMESTAMP, &timestamp);
+  const auto offset{ std::chrono::steady_clock::now().time_since_epoch()
+    - std::chrono::duration_cast<std::chrono::steady_clock::duration>(std::chrono::nanoseconds(timestamp)) };
+
+  // 結果が得られたクエリからイベントの取り出しから描画の完了までの時間を求める
+  while (!latencyQuery.empty())
+  {
+    GLint available;
+    glGetQueryObjectiv(latencyQuery.front().first, GL_QUERY_RESULT_AVAILABLE, &available);
+    if (!available)
+    {
+      // 結果が得られないクエリが溜まりすぎたら古いものを捨てる
+      if (latencyQuery.size() <= 4) break;
+    }
+    else
+    {
+      // 描画が完了した GPU の時刻を CPU の時刻に換算する
+      GLuint64 complete;
+      glGetQueryObjectui64v(latencyQuery.front().first, GL_QUERY_RESULT, &complete);
+      const std::chrono::steady_clock::time_point completeTime{ offset
+        + std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+          std::chrono::nanoseconds(static_cast<std::int64_t>(complete))) };
+      presentState->latency.store(std::chrono::duration<double>(completeTime
+        - latencyQuery.front().second).count(), std::memory_order_relaxed);
+    }
+
+    glDeleteQueries(1, &latencyQuery.front().first);
+    latencyQuery.pop_front();
+  }
+
+  // 結果が得られた GPU の区間を記録する
+  Profiler::collect();
+}
+
+//
+// フレームの表示間隔の制御方法を設定する
+//
+void GgApp::Window::setSwapMode(SwapMode mode, double fps)
+{
+  // 表示するスレッドに設定を要求する
+  if (fps > 0.0) presentState->requestInterval.store(1.0 / fps, std::memory_order_relaxed);
+  presentState->requestMode.store(mode, std::memory_order_release);
+
+  // このスレッドで表示するならすぐに設定する
+  if (glfwGetCurrentContext() == window) applySwapMode();
+}
+
+//
+// 要求されたフレームの表示間隔の制御方法を表示するスレッドで設定する
+//
+void GgApp::Window::applySwapMode()
+{
+  // 要求がなければ何もしない
+  const auto request{ presentState->requestMode.exchange(-1, std::memory_order_acquire) };
+  if (request < 0) return;
+  auto mode{ static_cast<SwapMode>(request) };
+
+  // 遅れたフレームだけ垂直同期を待たない拡張機能が使えなければ垂直同期に合わせる
+  if (mode == Adaptive
+    && !glfwExtensionSupported("WGL_EXT_swap_control_tear")
+    && !glfwExtensionSupported("GLX_EXT_swap_control_tear")) mode = VSync;
+
+  swapInterval = presentState->requestInterval.load(std::memory_order_relaxed);
+  presentState->swapMode.store(mode, std::memory_order_relaxed);
+
+  // スワップ間隔を設定する
+  glfwSwapInterval(mode == VSync ? 1 : mode == Adaptive ? -1 : 0);
 }
 
 //
@@ -536,10 +782,382 @@ void GgApp::Window::updateViewport()
   // ウィンドウの縦横比を保存する
   aspect = static_cast<GLfloat>(fboSize[0]) / static_cast<GLfloat>(fboSize[1]);
 
-  // ビューポートを設定する
-  restoreViewport();
+  // このウィンドウのコンテキストがカレントならビューポートを設定する
+  // 描画スレッドに移していれば描画スレッドが次のフレームで設定する
+  if (glfwGetCurrentContext() == window) restoreViewport();
 }
 
+//
+// プロファイラ：記録するなら true
+//
+std::atomic<bool> GgApp::Profiler::enabled{ false };
+
+//
+// プロファイラ：全てのスレッドの記録
+//
+std::vector<std::unique_ptr<GgApp::Profiler::Track>> GgApp::Profiler::tracks;
+
+//
+// プロファイラ：記録の追加の排他制御
+//
+std::mutex GgApp::Profiler::trackMutex;
+
+//
+// プロファイラ：GPU の区間の記録
+//
+std::unique_ptr<GgApp::Profiler::Track> GgApp::Profiler::gpuTrack{ std::make_unique<Track>("GPU") };
+
+//
+// プロファイラ：発行したタイムスタンプのクエリ
+//
+std::vector<GgApp::Profiler::GpuQuery> GgApp::Profiler::gpuQuery;
+
+//
+// プロファイラ：結果を取り出していないクエリの先頭と次に使うクエリの番号
+//
+std::size_t GgApp::Profiler::gpuHead{ 0 }, GgApp::Profiler::gpuTail{ 0 };
+
+//
+// プロファイラ：計測中の GPU の区間の入れ子の深さ
+//
+std::uint32_t GgApp::Profiler::gpuDepth{ 0 };
+
+//
+// プロファイラ：GPU のタイムスタンプを CPU の時刻に変換するときに加える値
+//
+std::int64_t GgApp::Profiler::gpuOffset{ 0 };
+
+//
+// プロファイラ：GPU の区間を計測するコンテキスト
+//
+std::atomic<GLFWwindow*> GgApp::Profiler::gpuContext{ nullptr };
+
+//
+// プロファイラ：スレッドの記録のコンストラクタ
+//
+GgApp::Profiler::Track::Track(const std::string& name) :
+  slot{ std::make_unique<Slot[]>(capacity) },
+  started{ 0 },
+  count{ 0 },
+  name{ name },
+  depth{ 0 }
+{
+}
+
+//
+// プロファイラ：区間を記録する
+//
+void GgApp::Profiler::Track::push(const char* name, std::int64_t begin, std::int64_t end, std::uint32_t depth)
+{
+  // 上書きを始めることを読み手に知らせてから書き込む
+  const auto n{ count.load(std::memory_order_relaxed) };
+  started.store(n + 1, std::memory_order_relaxed);
+  std::atomic_thread_fence(std::memory_order_release);
+
+  auto& s{ slot[n % capacity] };
+  s.name.store(name, std::memory_order_relaxed);
+  s.begin.store(begin, std::memory_order_relaxed);
+  s.end.store(end, std::memory_order_relaxed);
+  s.depth.store(depth, std::memory_order_relaxed);
+
+  // 書き込みの完了を公開する
+  count.store(n + 1, std::memory_order_release);
+}
+
+//
+// プロファイラ：記録した区間を複製する
+//
+std::vector<GgApp::Profiler::Event> GgApp::Profiler::Track::snapshot() const
+{
+  // 書き込みが完了している区間を複製する
+  const auto last{ count.load(std::memory_order_acquire) };
+  auto first{ last > capacity ? last - capacity : 0 };
+  std::vector<Event> event;
+  event.reserve(static_cast<std::size_t>(last - first));
+  for (auto i = first; i < last; ++i)
+  {
+    const auto& s{ slot[i % capacity] };
+    event.push_back(Event{ s.name.load(std::memory_order_relaxed), s.begin.load(std::memory_order_relaxed),
+      s.end.load(std::memory_order_relaxed), s.depth.load(std::memory_order_relaxed) });
+  }
+
+  // 複製している間に上書きが始まった区間を捨てる
+  std::atomic_thread_fence(std::memory_order_acquire);
+  const auto overwritten{ started.load(std::memory_order_relaxed) };
+  if (overwritten > first + capacity)
+    event.erase(event.begin(), event.begin() + static_cast<std::ptrdiff_t>(std::min<std::uint64_t>(overwritten - first - capacity, event.size())));
+
+  return event;
+}
+
+//
+// プロファイラ：このスレッドの記録を得る
+//
+GgApp::Profiler::Track& GgApp::Profiler::getTrack()
+{
+  // スレッドごとに最初に呼び出したときに記録を追加する
+  thread_local Track* track{ nullptr };
+  if (!track)
+  {
+    std::lock_guard<std::mutex> lock{ trackMutex };
+    tracks.emplace_back(std::make_unique<Track>("Thread " + std::to_string(tracks.size())));
+    track = tracks.back().get();
+  }
+
+  return *track;
+}
+
+//
+// プロファイラ：このスレッドの名前を設定する
+//
+void GgApp::Profiler::setThreadName(const std::string& name)
+{
+  auto& track{ getTrack() };
+  std::lock_guard<std::mutex> lock{ trackMutex };
+  track.name = name;
+}
+
+//
+// プロファイラ：GPU の区間の計測を開始する
+//
+GgApp::Profiler::GpuScope::GpuScope(const char* name) :
+  query{ -1 }
+{
+  // 記録しないときは計測しない
+  if (!enabled.load(std::memory_order_relaxed)) return;
+
+  // 最初に計測したコンテキスト以外では計測しない
+  // クエリの記録はこのコンテキストを使うスレッドだけが更新するので, 先に調べてから触れる
+  auto* const current{ glfwGetCurrentContext() };
+  GLFWwindow* expected{ nullptr };
+  if (!gpuContext.compare_exchange_strong(expected, current) && expected != current) return;
+
+  // 結果を待っているクエリが多すぎるときは計測しない
+  if (gpuTail - gpuHead >= gpuCapacity) return;
+
+  // クエリを用意する
+  if (gpuQuery.empty())
+  {
+    gpuQuery.resize(gpuCapacity);
+    for (auto& q : gpuQuery) glGenQueries(2, q.query.data());
+  }
+
+  // 開始時刻のタイムスタンプを記録する
+  query = static_cast<int>(gpuTail++ % gpuCapacity);
+  auto& q{ gpuQuery[query] };
+  q.name = name;
+  q.depth = gpuDepth++;
+  q.closed = false;
+  glQueryCounter(q.query[0], GL_TIMESTAMP);
+}
+
+//
+// プロファイラ：GPU の区間の計測を終了する
+//
+GgApp::Profiler::GpuScope::~GpuScope()
+{
+  if (query < 0) return;
+
+  // 終了時刻のタイムスタンプを記録する
+  auto& q{ gpuQuery[query] };
+  glQueryCounter(q.query[1], GL_TIMESTAMP);
+  q.closed = true;
+  --gpuDepth;
+}
+
+//
+// プロファイラ：結果が得られた GPU の区間を記録する
+//
+void GgApp::Profiler::collect()
+{
+  if (gpuContext.load() != glfwGetCurrentContext() || gpuQuery.empty()) return;
+
+  // GPU のタイムスタンプと CPU の時刻の差を求める
+  GLint64 timestamp;
+  glGetInteger64v(GL_TIMESTAMP, &timestamp);
+  gpuOffset = now() - static_cast<std::int64_t>(timestamp);
+
+  // 古いものから順に結果が得られたクエリを取り出す
+  while (gpuHead < gpuTail)
+  {
+    // 計測中の区間は終了時刻のクエリがまだ発行されていない
+    const auto& q{ gpuQuery[gpuHead % gpuCapacity] };
+    if (!q.closed) break;
+
+    GLint available;
+    glGetQueryObjectiv(q.query[1], GL_QUERY_RESULT_AVAILABLE, &available);
+    if (!available) break;
+
+    GLuint64 begin, end;
+    glGetQueryObjectui64v(q.query[0], GL_QUERY_RESULT, &begin);
+    glGetQueryObjectui64v(q.query[1], GL_QUERY_RESULT, &end);
+    gpuTrack->push(q.name, static_cast<std::int64_t>(begin) + gpuOffset, static_cast<std::int64_t>(end) + gpuOffset, q.depth);
+    ++gpuHead;
+  }
+}
+
+//
+// プロファイラ：全ての記録を複製する
+//
+std::vector<std::pair<std::string, std::vector<GgApp::Profiler::Event>>> GgApp::Profiler::snapshot()
+{
+  std::vector<std::pair<std::string, std::vector<Event>>> result;
+
+  {
+    std::lock_guard<std::mutex> lock{ trackMutex };
+    for (const auto& track : tracks) result.emplace_back(track->name, track->snapshot());
+  }
+  result.emplace_back(gpuTrack->name, gpuTrack->snapshot());
+
+  return result;
+}
+
+//
+// プロファイラ：記録を Chrome のトレース形式の JSON ファイルに書き出す
+//
+bool GgApp::Profiler::exportChromeTrace(const std::string& path)
+{
+  std::ofstream file{ path };
+  if (!file) return false;
+
+  // 文字列を JSON の文字列に変換する
+  const auto quote{ [](const char* text)
+  {
+    std::string s{ "\"" };
+    for (const char* c = text ? text : ""; *c; ++c)
+    {
+      if (*c == '"' || *c == '\\') s += '\\';
+      if (static_cast<unsigned char>(*c) >= 0x20) s += *c;
+    }
+    return s + '"';
+  } };
+
+  // 記録を全て書き出す
+  const auto all{ snapshot() };
+  file << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[";
+  const char* separator{ "\n" };
+  for (std::size_t tid = 0; tid < all.size(); ++tid)
+  {
+    // スレッドの名前
+    file << separator << "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":" << tid
+      << ",\"args\":{\"name\":" << quote(all[tid].first.c_str()) << "}}";
+    separator = ",\n";
+
+    // 区間
+    for (const auto& e : all[tid].second)
+    {
+      file << separator << "{\"name\":" << quote(e.name) << ",\"cat\":\""
+        << (tid + 1 == all.size() ? "gpu" : "cpu") << "\",\"ph\":\"X\",\"pid\":1,\"tid\":" << tid
+        << ",\"ts\":" << e.begin / 1000 << '.' << std::setw(3) << std::setfill('0') << e.begin % 1000
+        << ",\"dur\":" << (e.end - e.begin) / 1000 << '.' << std::setw(3) << std::setfill('0') << (e.end - e.begin) % 1000
+        << "}";
+    }
+  }
+  file << "\n]}\n";
+
+  return static_cast<bool>(file);
+}
+
+#if defined(IMGUI_VERSION)
+//
+// プロファイラ：タイムラインを ImGui のウィンドウに表示する
+//
+void GgApp::Profiler::draw(bool* open)
+{
+  // 表示する時間の幅 (ms) と表示の一時停止
+  static float range{ 50.0f };
+  static bool paused{ false };
+  static std::vector<std::pair<std::string, std::vector<Event>>> frozen;
+  static std::int64_t frozenTime{ 0 };
+
+  ImGui::SetNextWindowSize(ImVec2(640, 320), ImGuiCond_FirstUseEver);
+  if (!ImGui::Begin(u8"プロファイラ", open))
+  {
+    ImGui::End();
+    return;
+  }
+
+  // 操作
+  auto recording{ isEnabled() };
+  if (ImGui::Checkbox(u8"記録", &recording)) setEnabled(recording);
+  ImGui::SameLine();
+  if (ImGui::Checkbox(u8"一時停止", &paused) && paused)
+  {
+    frozen = snapshot();
+    frozenTime = now();
+  }
+  ImGui::SameLine();
+  ImGui::SetNextItemWidth(160.0f);
+  ImGui::SliderFloat(u8"範囲 (ms)", &range, 1.0f, 1000.0f, "%.0f", ImGuiSliderFlags_Logarithmic);
+  ImGui::SameLine();
+  if (ImGui::Button(u8"書き出し")) exportChromeTrace("trace.json");
+
+  // 表示する記録と時間の範囲
+  const auto& all{ paused ? frozen : snapshot() };
+  const auto t1{ paused ? frozenTime : now() };
+  const auto t0{ t1 - static_cast<std::int64_t>(range * 1.0e6f) };
+
+  // タイムラインを描く領域
+  auto* const list{ ImGui::GetWindowDrawList() };
+  const auto rowHeight{ ImGui::GetTextLineHeight() + 2.0f };
+  const auto labelWidth{ 96.0f };
+  const auto origin{ ImGui::GetCursorScreenPos() };
+  const auto width{ std::max(ImGui::GetContentRegionAvail().x - labelWidth, 1.0f) };
+  const auto scale{ width / static_cast<float>(t1 - t0) };
+  const auto left{ origin.x + labelWidth };
+  auto y{ origin.y };
+
+  // マウスの位置にある区間
+  const auto mouse{ ImGui::GetIO().MousePos };
+  const Event* hovered{ nullptr };
+
+  for (const auto& [name, events] : all)
+  {
+    // 表示範囲の入れ子の深さ
+    std::uint32_t depth{ 0 };
+    for (const auto& e : events) if (e.end >= t0 && e.begin <= t1) depth = std::max(depth, e.depth + 1);
+
+    // スレッドの名前と区切り
+    list->AddText(ImVec2(origin.x, y), ImGui::GetColorU32(ImGuiCol_Text), name.c_str());
+    list->AddLine(ImVec2(left, y), ImVec2(left + width, y), ImGui::GetColorU32(ImGuiCol_Separator));
+
+    // 区間の帯
+    for (const auto& e : events)
+    {
+      if (e.end < t0 || e.begin > t1) continue;
+
+      const ImVec2 p0{ left + std::max(static_cast<float>(e.begin - t0) * scale, 0.0f), y + e.depth * rowHeight };
+      const ImVec2 p1{ std::max(left + std::min(static_cast<float>(e.end - t0) * scale, width), p0.x + 1.0f), p0.y + rowHeight - 1.0f };
+
+      // 名前から色を決める
+      const auto hash{ static_cast<std::uint32_t>(std::hash<const void*>{}(e.name)) };
+      const auto color{ ImColor::HSV(static_cast<float>(hash % 360u) / 360.0f, 0.5f, 0.8f) };
+      list->AddRectFilled(p0, p1, color);
+
+      // 幅が足りれば名前を表示する
+      if (p1.x - p0.x > 24.0f)
+      {
+        const ImVec4 clip{ p0.x, p0.y, p1.x, p1.y };
+        list->AddText(nullptr, 0.0f, ImVec2(p0.x + 2.0f, p0.y + 1.0f), IM_COL32_BLACK, e.name, nullptr, 0.0f, &clip);
+      }
+
+      if (mouse.x >= p0.x && mouse.x < p1.x && mouse.y >= p0.y && mouse.y < p1.y) hovered = &e;
+    }
+
+    y += std::max(depth, 1u) * rowHeight + 4.0f;
+  }
+
+  // 描いた領域を確保する
+  ImGui::Dummy(ImVec2(labelWidth + width, y - origin.y));
+
+  // マウスの位置にある区間の情報
+  if (hovered && ImGui::IsWindowHovered())
+    ImGui::SetTooltip("%s\n%.3f ms", hovered->name, static_cast<double>(hovered->end - hovered->begin) * 1.0e-6);
+
+  ImGui::End();
+}
+#endif
+
 #if defined(GG_USE_OCULUS_RIFT)
 #  if OVR_PRODUCT_VERSION > 0
 //
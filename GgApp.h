@@ -56,6 +56,18 @@ using namespace gg;
 #include <cassert>
 #include <stdexcept>
 #include <iostream>
+#include <chrono>
+#include <deque>
+#include <thread>
+#include <atomic>
+#include <functional>
+#include <cstdint>
+#include <mutex>
+#include <condition_variable>
+#include <type_traits>
+#include <exception>
+#include <fstream>
+#include <iomanip>
 
 // ImGui の組み込み
 #if defined(GG_USE_IMGUI)
@@ -135,6 +147,27 @@ public:
   ///
   class Window
   {
+  public:
+
+    ///
+    /// フレームの表示間隔の制御方法.
+    ///
+    enum SwapMode
+    {
+      VSync = 0,                          ///< 垂直同期に合わせる.
+      Uncapped,                           ///< 垂直同期を待たずに表示する.
+      Capped,                             ///< 垂直同期を待たずに指定したフレームレートで表示する.
+      Adaptive                            ///< 遅れたフレームだけ垂直同期を待たずに表示する.
+    };
+
+    /// フレーム時間のヒストグラムの階級の数.
+    static constexpr int histogramSize{ 64 };
+
+    /// フレーム時間のヒストグラムの階級の幅 [秒].
+    static constexpr double histogramStep{ 0.001 };
+
+  private:
+
     // ウィンドウの識別子
     GLFWwindow* window;
 
@@ -147,6 +180,15 @@ public:
 #if defined(IMGUI_VERSION)
     // メニューバーの高さ
     GLsizei menubarHeight;
+
+    // ImGui のフレームを作成するなら true
+    bool imguiVisible;
+
+    // このフレームで ImGui のフレームを作成していれば true
+    bool imguiFrame;
+
+    // ImGui を結び付けたウィンドウなら true
+    bool imguiOwner;
 #endif
 
     // ビューポートの縦横比
@@ -201,11 +243,133 @@ public:
       void calcTranslation(int button, const std::array<GLfloat, 3>& velocity);
     };
 
-    // ヒューマンインタフェースデバイスのデータ
+    // ヒューマンインタフェースデバイスのデータ (イベントを処理するスレッドで更新する)
     std::array<HumanInterface, GG_INTERFACE_COUNT> interfaceData;
 
-    // ヒューマンインタフェースデバイスの番号
-    int interfaceNo;
+    // ヒューマンインタフェースデバイスのデータのスナップショット
+    struct InterfaceSnapshot
+    {
+      // 版数
+      std::uint64_t version;
+
+      // ヒューマンインタフェースデバイスのデータの複製
+      std::array<HumanInterface, GG_INTERFACE_COUNT> data;
+    };
+
+    // スナップショットの三重バッファ
+    struct InterfaceBuffer
+    {
+      // 最新のスナップショットが未読であることを示すビット
+      static constexpr unsigned int fresh{ 4u };
+
+      // スナップショット
+      std::array<InterfaceSnapshot, 3> snapshot{};
+
+      // 最新のスナップショットの番号と fresh ビット
+      std::atomic<unsigned int> latest{ 2u };
+
+      // 読み手からの初期化の要求 (インタフェースごとに回転と平行移動の 2 ビット)
+      std::atomic<unsigned int> request{ 0u };
+
+      // 選択されているヒューマンインタフェースデバイスの番号
+      std::atomic<int> number{ 0 };
+
+      // 他のスレッドから描画し直しを要求されていれば true
+      std::atomic<bool> invalid{ true };
+
+      // 書き手が最後に公開したスナップショットの版数
+      std::uint64_t version{ 0 };
+
+      // 書き手が次に書き込むスナップショットの番号
+      int back{ 0 };
+
+      // 読み手が参照しているスナップショットの番号
+      int front{ 1 };
+    };
+
+    // スナップショットの三重バッファ (Window をムーブできるようにポインタで保持する)
+    std::unique_ptr<InterfaceBuffer> interfaceBuffer;
+
+    // イベントを取り出したときにスナップショットを自動的に取得するなら true
+    bool autoAcquire;
+
+    //
+    // イベントを処理するスレッドで選択されているヒューマンインタフェースデバイスのデータを得る
+    //
+    HumanInterface& getCurrentInterface()
+    {
+      return interfaceData[interfaceBuffer->number.load(std::memory_order_relaxed)];
+    }
+
+    //
+    // 読み手が参照しているスナップショットの選択されているヒューマンインタフェースデバイスのデータを得る
+    //
+    const HumanInterface& getInterface() const
+    {
+      const auto& b{ *interfaceBuffer };
+      return b.snapshot[b.front].data[b.number.load(std::memory_order_relaxed)];
+    }
+    HumanInterface& getInterface()
+    {
+      auto& b{ *interfaceBuffer };
+      return b.snapshot[b.front].data[b.number.load(std::memory_order_relaxed)];
+    }
+
+    //
+    // ヒューマンインタフェースデバイスのデータのスナップショットを公開する
+    //
+    void publishInput();
+
+    // フレームの表示の設定と計測結果 (描画スレッドとメインスレッドで共有する)
+    struct PresentState
+    {
+      // 要求されたフレームの表示間隔の制御方法, 要求がなければ負
+      std::atomic<int> requestMode{ -1 };
+
+      // 要求された Capped のときのフレームの表示間隔 [秒]
+      std::atomic<double> requestInterval{ 1.0 / 60.0 };
+
+      // 実際に設定されているフレームの表示間隔の制御方法
+      std::atomic<int> swapMode{ VSync };
+
+      // 直前のフレームの表示間隔 [秒]
+      std::atomic<double> frameTime{ 0.0 };
+
+      // 直前に計測したイベントの取り出しから描画の完了までの時間 [秒]
+      std::atomic<double> latency{ 0.0 };
+
+      // フレームの表示間隔のヒストグラム
+      std::array<std::atomic<unsigned int>, histogramSize> histogram{};
+    };
+
+    // フレームの表示の設定と計測結果 (Window をムーブできるようにポインタで保持する)
+    std::unique_ptr<PresentState> presentState;
+
+    // Capped のときのフレームの表示間隔 [秒] (表示するスレッドで更新する)
+    double swapInterval;
+
+    // 直前にカラーバッファを入れ替えた時刻 (表示するスレッドで更新する)
+    std::chrono::steady_clock::time_point swapTime;
+
+    // イベントを取り出した時刻 (イベントを処理するスレッドで更新する)
+    std::chrono::steady_clock::time_point inputTime;
+
+    // 描画の完了時刻を記録するタイムスタンプのクエリとそのフレームのイベントを取り出した時刻
+    std::deque<std::pair<GLuint, std::chrono::steady_clock::time_point>> latencyQuery;
+
+    //
+    // 要求されたフレームの表示間隔の制御方法を表示するスレッドで設定する
+    //
+    void applySwapMode();
+
+    // 描画し直す必要がなければイベントを待つなら true
+    bool idleMode;
+
+    // イベントがなくても描画し直す間隔 [秒]
+    double idleInterval;
+
+    // イベントを待ったあとに続けて描画するフレームの残り
+    int idleFrames;
 
     //
     // ユーザー定義のコールバック関数へのポインタ
@@ -268,6 +432,10 @@ public:
       // ウィンドウが作成されていなければ戻る
       if (!window) return;
 
+      // 計測中のクエリを削除する
+      glfwMakeContextCurrent(window);
+      for (const auto& q : latencyQuery) glDeleteQueries(1, &q.first);
+
       // ウィンドウを破棄する
       glfwDestroyWindow(window);
     }
@@ -320,14 +488,163 @@ public:
     ///
     explicit operator bool();
 
+    ///
+    /// 取り出したイベントを処理してループを継続すべきかどうか調べる.
+    ///
+    /// @return ループを継続すべきなら true.
+    ///
+    /// @note
+    /// operator bool() からイベントの取り出しを除いたもので, 複数のウィンドウのイベントを
+    /// 一度の glfwPollEvents() で取り出したあとにウィンドウごとに呼び出す.
+    ///
+    bool update();
+
     ///
     /// カラーバッファを入れ替える.
     ///
-    void swapBuffers() const;
+    /// @note
+    /// setSwapMode() で Capped を指定したときは指定したフレームレートになるまで待つ.
+    /// フレームの表示間隔とイベントの取り出しから描画の完了までの時間もここで計測する.
+    ///
+    void swapBuffers();
+
+    ///
+    /// ImGui のフレームをレンダリングせずにカラーバッファを入れ替える.
+    ///
+    /// @param input このフレームのイベントを取り出した時刻.
+    ///
+    /// @note
+    /// swapBuffers() から ImGui の描画を除いたもので, Renderer の描画スレッドから呼び出す.
+    ///
+    void present(std::chrono::steady_clock::time_point input);
+
+    ///
+    /// フレームの表示間隔の制御方法を設定する.
+    ///
+    /// @param mode フレームの表示間隔の制御方法.
+    /// @param fps mode が Capped のときのフレームレート.
+    ///
+    /// @note
+    /// このウィンドウのコンテキストがカレントならすぐに設定し, そうでなければ
+    /// Renderer の描画スレッドが次に present() を呼び出したときに設定する.
+    /// Adaptive は WGL_EXT_swap_control_tear か GLX_EXT_swap_control_tear が使えなければ VSync になる.
+    ///
+    void setSwapMode(SwapMode mode, double fps = 60.0);
+
+    ///
+    /// フレームの表示間隔の制御方法を得る.
+    ///
+    /// @return 実際に設定されているフレームの表示間隔の制御方法.
+    ///
+    auto getSwapMode() const
+    {
+      return static_cast<SwapMode>(presentState->swapMode.load(std::memory_order_relaxed));
+    }
+
+    ///
+    /// 描画し直す必要がなければイベントを待つかどうかを設定する.
+    ///
+    /// @param flag true ならアニメーションなどで invalidate() が呼ばれていない限り operator bool() でイベントを待つ.
+    /// @param interval イベントがなくても描画し直す間隔 [秒].
+    ///
+    /// @note
+    /// 入力があるか invalidate() が呼ばれるか interval が経過すると待機を終える.
+    /// ImGui の表示が落ち着くように, 待機を終えたあとは数フレーム続けて描画する.
+    ///
+    void setIdleMode(bool flag, double interval = 1.0)
+    {
+      idleMode = flag;
+      if (interval > 0.0) idleInterval = interval;
+    }
+
+    ///
+    /// イベントを待つかどうかを得る.
+    ///
+    /// @return 描画し直す必要がなければイベントを待つなら true.
+    ///
+    bool getIdleMode() const
+    {
+      return idleMode;
+    }
+
+    ///
+    /// 次のフレームを描画し直すことを要求する.
+    ///
+    /// @note
+    /// どのスレッドから呼び出してもよく, operator bool() でイベントを待っていれば待機を終わらせる.
+    /// アニメーションや画像の蓄積の途中, あるいはバックグラウンドの処理を待っている間は毎フレーム呼び出す.
+    ///
+    void invalidate() const
+    {
+      interfaceBuffer->invalid.store(true, std::memory_order_release);
+      glfwPostEmptyEvent();
+    }
+
+    ///
+    /// 直前のフレームの表示間隔を得る.
+    ///
+    /// @return 直前の swapBuffers() からの経過時間 [秒].
+    ///
+    auto getFrameTime() const
+    {
+      return presentState->frameTime.load(std::memory_order_relaxed);
+    }
+
+    ///
+    /// イベントの取り出しから描画の完了までの時間を得る.
+    ///
+    /// @return 最後に描画の完了を確認したフレームのイベントの取り出しからの経過時間 [秒].
+    ///
+    /// @note
+    /// カラーバッファの入れ替え後に記録した GPU のタイムスタンプを CPU の時刻に換算して求めるので,
+    /// 完了を確認したときではなく GPU が描画を完了した時刻に基づくが, 結果は数フレーム前の値になる.
+    ///
+    auto getLatency() const
+    {
+      return presentState->latency.load(std::memory_order_relaxed);
+    }
+
+    ///
+    /// フレームの表示間隔のヒストグラムを得る.
+    ///
+    /// @return histogramStep ごとの度数を格納した配列の複製, 最後の要素はそれを超えるものを含む.
+    ///
+    auto getHistogram() const
+    {
+      std::array<unsigned int, histogramSize> histogram;
+      for (int i = 0; i < histogramSize; ++i)
+        histogram[i] = presentState->histogram[i].load(std::memory_order_relaxed);
+      return histogram;
+    }
+
+    ///
+    /// フレームの表示間隔のヒストグラムを初期化する.
+    ///
+    void resetHistogram()
+    {
+      for (auto& h : presentState->histogram) h.store(0, std::memory_order_relaxed);
+    }
+
+    ///
+    /// イベントを取り出した時刻を得る.
+    ///
+    /// @return 直前に operator bool() か update() でイベントを処理した時刻.
+    ///
+    /// @note
+    /// イベントを処理するスレッドで呼び出す.
+    ///
+    auto getInputTime() const
+    {
+      return inputTime;
+    }
 
     ///
     /// ビューポートを元のサイズに復帰する.
     ///
+    /// @note
+    /// ウィンドウの状態を調べるのでメインスレッドで呼び出す.
+    /// Renderer の描画スレッドでは submit() したときのサイズでビューポートを設定する.
+    ///
     void restoreViewport() const
     {
       if (!glfwGetWindowAttrib(window, GLFW_ICONIFIED)) glViewport(0, 0, fboSize[0], fboSize[1]);
@@ -352,6 +669,33 @@ public:
       // ビューポートを復帰する
       updateViewport();
     }
+
+    ///
+    /// ImGui のフレームを作成するかどうかを設定する.
+    ///
+    /// @param visible false なら次のフレームから ImGui のフレームの作成と描画を省略する.
+    ///
+    /// @note
+    /// メニューなどを表示しない間は false にしておけば, ImGui の描画リストの作成と転送を行わない.
+    /// 省略している間に ImGui に届いたイベントは捨てる.
+    ///
+    void setImGuiVisible(bool visible)
+    {
+      imguiVisible = visible;
+    }
+
+    ///
+    /// このフレームで ImGui のフレームを作成したかどうかを調べる.
+    ///
+    /// @return ImGui の関数を呼び出してよければ true.
+    ///
+    /// @note
+    /// ImGui は最初に開いたウィンドウにだけ結び付けるので, それ以外のウィンドウでは常に false になる.
+    ///
+    bool getImGuiFrame() const
+    {
+      return imguiFrame;
+    }
 #endif
 
     ///
@@ -469,7 +813,42 @@ public:
     void selectInterface(int no)
     {
       assert(static_cast<size_t>(no) < interfaceData.size());
-      interfaceNo = no;
+      interfaceBuffer->number.store(no, std::memory_order_relaxed);
+    }
+
+    ///
+    /// ヒューマンインタフェースデバイスのデータの最新のスナップショットを取得する.
+    ///
+    /// @return 新しいスナップショットを取得したら true.
+    ///
+    /// @note
+    /// マウスや矢印キーの値を得る関数はここで取得したスナップショットを参照する.
+    /// イベントを処理するスレッドはロックせずにスナップショットを公開するので, 読み手が待たされることはない.
+    /// 自動取得が有効なら operator bool() の中で呼び出される.
+    ///
+    bool acquireInput();
+
+    ///
+    /// スナップショットの自動取得を設定する.
+    ///
+    /// @param flag true なら operator bool() でイベントを取り出すたびにスナップショットを取得する.
+    ///
+    /// @note
+    /// イベントの処理と描画を別のスレッドで行うときは false にして, 描画するスレッドで acquireInput() を呼び出す.
+    ///
+    void setAutoAcquire(bool flag)
+    {
+      autoAcquire = flag;
+    }
+
+    ///
+    /// 参照しているスナップショットの版数を得る.
+    ///
+    /// @return スナップショットを公開するたびに増える版数.
+    ///
+    auto getInputVersion() const
+    {
+      return interfaceBuffer->snapshot[interfaceBuffer->front].version;
     }
 
     ///
@@ -491,7 +870,7 @@ public:
     ///
     int getLastKey()
     {
-      auto& current_if{ interfaceData[interfaceNo] };
+      auto& current_if{ getInterface() };
       const int key{ current_if.lastKey };
       current_if.lastKey = 0;
       return key;
@@ -506,7 +885,7 @@ public:
     ///
     auto getArrow(int direction = 0, int mods = 0) const
     {
-      const auto& current_if{ interfaceData[interfaceNo] };
+      const auto& current_if{ getInterface() };
       return static_cast<GLfloat>(current_if.arrow[mods & 3][direction & 1]);
     }
 
@@ -644,7 +1023,7 @@ public:
     ///
     const auto* getMouse() const
     {
-      const auto& current_if{ interfaceData[interfaceNo] };
+      const auto& current_if{ getInterface() };
       return current_if.mouse.data();
     }
 
@@ -655,7 +1034,7 @@ public:
     ///
     void getMouse(GLfloat* position) const
     {
-      const auto& current_if{ interfaceData[interfaceNo] };
+      const auto& current_if{ getInterface() };
       position[0] = current_if.mouse[0];
       position[1] = current_if.mouse[1];
     }
@@ -668,7 +1047,7 @@ public:
     ///
     auto getMouse(int direction) const
     {
-      const auto& current_if{ interfaceData[interfaceNo] };
+      const auto& current_if{ getInterface() };
       return current_if.mouse[direction & 1];
     }
 
@@ -679,7 +1058,7 @@ public:
     ///
     auto getMouseX() const
     {
-      const auto& current_if{ interfaceData[interfaceNo] };
+      const auto& current_if{ getInterface() };
       return current_if.mouse[0];
     }
 
@@ -690,7 +1069,7 @@ public:
     ///
     auto getMouseY() const
     {
-      const auto& current_if{ interfaceData[interfaceNo] };
+      const auto& current_if{ getInterface() };
       return current_if.mouse[1];
     }
 
@@ -701,7 +1080,7 @@ public:
     ///
     const auto* getWheel() const
     {
-      const auto& current_if{ interfaceData[interfaceNo] };
+      const auto& current_if{ getInterface() };
       return current_if.wheel.data();
     }
 
@@ -712,7 +1091,7 @@ public:
     ///
     void getWheel(GLfloat* rotation) const
     {
-      const auto& current_if{ interfaceData[interfaceNo] };
+      const auto& current_if{ getInterface() };
       rotation[0] = current_if.wheel[0];
       rotation[1] = current_if.wheel[1];
     }
@@ -725,7 +1104,7 @@ public:
     ///
     auto getWheel(int direction) const
     {
-      const auto& current_if{ interfaceData[interfaceNo] };
+      const auto& current_if{ getInterface() };
       return current_if.wheel[direction & 1];
     }
 
@@ -736,7 +1115,7 @@ public:
     ///
     auto getWheelX() const
     {
-      const auto& current_if{ interfaceData[interfaceNo] };
+      const auto& current_if{ getInterface() };
       return current_if.wheel[0];
     }
 
@@ -747,7 +1126,7 @@ public:
     ///
     auto getWheelY() const
     {
-      const auto& current_if{ interfaceData[interfaceNo] };
+      const auto& current_if{ getInterface() };
       return current_if.wheel[1];
     }
 
@@ -759,7 +1138,7 @@ public:
     ///
     const auto& getTranslation(int button = GLFW_MOUSE_BUTTON_1) const
     {
-      const auto& current_if{ interfaceData[interfaceNo] };
+      const auto& current_if{ getInterface() };
       assert(button >= GLFW_MOUSE_BUTTON_1 && button < GLFW_MOUSE_BUTTON_1 + GG_BUTTON_COUNT);
       return current_if.translation[button][1];
     }
@@ -772,7 +1151,7 @@ public:
     ///
     auto getTranslationMatrix(int button = GLFW_MOUSE_BUTTON_1) const
     {
-      const auto& current_if{ interfaceData[interfaceNo] };
+      const auto& current_if{ getInterface() };
       assert(button >= GLFW_MOUSE_BUTTON_1 && button < GLFW_MOUSE_BUTTON_1 + GG_BUTTON_COUNT);
       const auto& t{ current_if.translation[button][1] };
 
@@ -795,7 +1174,7 @@ public:
     ///
     auto getScrollMatrix(int button = GLFW_MOUSE_BUTTON_1) const
     {
-      const auto& current_if{ interfaceData[interfaceNo] };
+      const auto& current_if{ getInterface() };
       assert(button >= GLFW_MOUSE_BUTTON_1 && button < GLFW_MOUSE_BUTTON_1 + GG_BUTTON_COUNT);
       const auto& t{ current_if.translation[button][1] };
 
@@ -818,7 +1197,7 @@ public:
     ///
     auto getRotation(int button = GLFW_MOUSE_BUTTON_1) const
     {
-      const auto& current_if{ interfaceData[interfaceNo] };
+      const auto& current_if{ getInterface() };
       assert(button >= GLFW_MOUSE_BUTTON_1 && button < GLFW_MOUSE_BUTTON_1 + GG_BUTTON_COUNT);
       return current_if.rotation[button].getQuaternion();
     }
@@ -831,7 +1210,7 @@ public:
     ///
     auto getRotationMatrix(int button = GLFW_MOUSE_BUTTON_1) const
     {
-      const auto& current_if{ interfaceData[interfaceNo] };
+      const auto& current_if{ getInterface() };
       assert(button >= GLFW_MOUSE_BUTTON_1 && button < GLFW_MOUSE_BUTTON_1 + GG_BUTTON_COUNT);
       return current_if.rotation[button].getMatrix();
     }
@@ -841,8 +1220,12 @@ public:
     ///
     void resetRotation()
     {
-      // トラックボールを初期化する
-      for (auto& tb : interfaceData[interfaceNo].rotation) tb.reset();
+      // イベントを処理するスレッドに初期化を要求する
+      const auto no{ interfaceBuffer->number.load(std::memory_order_relaxed) };
+      interfaceBuffer->request.fetch_or(1u << (no * 2), std::memory_order_release);
+
+      // 参照しているスナップショットのトラックボールも初期化する
+      for (auto& tb : getInterface().rotation) tb.reset();
     }
 
     ///
@@ -850,8 +1233,12 @@ public:
     ///
     void resetTranslation()
     {
-      // 現在のインターフェースの平行移動量を初期化する
-      interfaceData[interfaceNo].resetTranslation();
+      // イベントを処理するスレッドに初期化を要求する
+      const auto no{ interfaceBuffer->number.load(std::memory_order_relaxed) };
+      interfaceBuffer->request.fetch_or(2u << (no * 2), std::memory_order_release);
+
+      // 参照しているスナップショットの平行移動量も初期化する
+      getInterface().resetTranslation();
     }
 
     ///
@@ -927,67 +1314,1314 @@ public:
     }
   };
 
-#if defined(GG_USE_OCULUS_RIFT)
   ///
-  /// Oculus Rift 関連の処理.
+  /// 単一の送り手と単一の受け手の間のロックを使わない待ち行列.
+  ///
+  /// @tparam T 要素の型, ムーブ代入できること.
+  /// @tparam N 待ち行列の長さ, 保持できる要素の数は N - 1.
   ///
   /// @note
-  /// Oculus Rift を操作するラッパークラス（シングルトン）.
+  /// push() は一つのスレッドだけから, pop() は別の一つのスレッドだけから呼び出す.
   ///
-  class Oculus
+  template <typename T, std::size_t N>
+  class Queue
   {
-    // Oculus Rift のセッション
-    ovrSession session;
+    static_assert(N >= 2, "Queue needs at least two slots.");
 
-    // Oculus Rift の状態
-    ovrHmdDesc hmdDesc;
+    // 要素を格納するリングバッファ
+    std::array<T, N> slot;
 
-    // Oculus Rift へのレンダリングに使う FBO
-    GLuint oculusFbo[ovrEye_Count];
+    // 受け手が次に取り出す位置
+    alignas(64) std::atomic<std::size_t> head;
 
-    // Oculus Rift のスクリーンのサイズ
-    GLfloat screen[ovrEye_Count][4];
+    // 送り手が次に格納する位置
+    alignas(64) std::atomic<std::size_t> tail;
 
-    // ミラー表示用の FBO
-    GLuint mirrorFbo;
+  public:
 
-    // Oculus Rift のミラー表示を行うウィンドウ
-    const Window* window;
+    ///
+    /// コンストラクタ.
+    ///
+    Queue() :
+      slot{},
+      head{ 0 },
+      tail{ 0 }
+    {
+    }
 
-#  if OVR_PRODUCT_VERSION > 0
+    ///
+    /// 要素を末尾に追加する.
+    ///
+    /// @param value 追加する要素, 追加できたときはムーブされる.
+    /// @return 待ち行列がいっぱいで追加できなければ false.
+    ///
+    bool push(T&& value)
+    {
+      const auto t{ tail.load(std::memory_order_relaxed) };
+      const auto next{ (t + 1) % N };
+      if (next == head.load(std::memory_order_acquire)) return false;
+      slot[t] = std::move(value);
+      tail.store(next, std::memory_order_release);
+      return true;
+    }
 
-    // Oculus Rift に送る描画データ
-    ovrLayerEyeFov layerData;
+    ///
+    /// 先頭の要素を取り出す.
+    ///
+    /// @param value 取り出した要素の格納先.
+    /// @return 待ち行列が空なら false.
+    ///
+    bool pop(T& value)
+    {
+      const auto h{ head.load(std::memory_order_relaxed) };
+      if (h == tail.load(std::memory_order_acquire)) return false;
+      value = std::move(slot[h]);
+      head.store((h + 1) % N, std::memory_order_release);
+      return true;
+    }
 
-    // Oculus Rift にレンダリングするフレームの番号
-    long long frameIndex;
+    ///
+    /// 待ち行列が空かどうか調べる.
+    ///
+    /// @return 空なら true.
+    ///
+    bool empty() const
+    {
+      return head.load(std::memory_order_acquire) == tail.load(std::memory_order_acquire);
+    }
 
-    // Oculus Rift へのレンダリングに使う FBO のデプステクスチャ
-    GLuint oculusDepth[ovrEye_Count];
+    ///
+    /// 待ち行列がいっぱいかどうか調べる.
+    ///
+    /// @return いっぱいなら true.
+    ///
+    bool full() const
+    {
+      return (tail.load(std::memory_order_acquire) + 1) % N == head.load(std::memory_order_acquire);
+    }
+  };
 
-    // ミラー表示用の FBO のサイズ
-    int mirrorWidth, mirrorHeight;
+  ///
+  /// 描画スレッド.
+  ///
+  /// @tparam Packet メインスレッドから描画スレッドに送るフレームごとのデータの型, デフォルトコンストラクタとムーブ代入ができること.
+  ///
+  /// @note
+  /// ウィンドウのコンテキストを描画スレッドに移し, メインスレッドはイベントの処理と ImGui のフレームの作成だけを行う.
+  /// メインスレッドは submit() でフレームのデータと ImGui の描画リストの複製を Queue に送り,
+  /// 描画スレッドはそれを受け取って描画関数を呼び出し, ImGui を描画して Window::present() で表示する.
+  /// 描画スレッドが動いている間はメインスレッドで OpenGL の関数を呼び出してはいけない.
+  ///
+  template <typename Packet>
+  class Renderer
+  {
+#if defined(IMGUI_VERSION)
+    // ImGui の描画リストを解放する
+    struct DrawListDeleter
+    {
+      void operator()(ImDrawList* list) const
+      {
+        IM_DELETE(list);
+      }
+    };
+#endif
 
-    // ミラー表示用の FBO のカラーテクスチャ
-    ovrMirrorTexture mirrorTexture;
+    // 描画スレッドに送るフレーム
+    struct Frame
+    {
+      // フレームごとのデータ
+      Packet packet;
 
-    //
-    // グラフィックスカードのデフォルトの LUID を得る
-    //
-    static ovrGraphicsLuid GetDefaultAdapterLuid();
+      // メインスレッドで取得したビューポートのサイズ
+      std::array<GLsizei, 2> viewport{};
 
-    //
-    // グラフィックスカードの LUID の比較
-    //
-    static int Compare(const ovrGraphicsLuid& lhs, const ovrGraphicsLuid& rhs);
+      // メインスレッドで取得したウィンドウのアイコン化の状態
+      bool iconified{ false };
 
-#  else
+      // このフレームのイベントを取り出した時刻
+      std::chrono::steady_clock::time_point inputTime;
 
-    // Oculus Rift に送る描画データ
-    ovrLayer_Union layerData;
+#if defined(IMGUI_VERSION)
+      // ImGui の描画データ
+      ImDrawData drawData;
 
-    // Oculus Rift のレンダリング情報
-    ovrEyeRenderDesc eyeRenderDesc[ovrEye_Count];
+      // ImGui の描画リストの複製
+      std::vector<std::unique_ptr<ImDrawList, DrawListDeleter>> drawList;
+#endif
+    };
+
+    // 描画するウィンドウ
+    Window& window;
+
+    // 描画関数
+    const std::function<void(const Packet&)> render;
+
+    // フレームの待ち行列
+    Queue<Frame, 4> queue;
+
+    // 描画スレッドを継続するとき true
+    std::atomic<bool> running;
+
+    // 待ち行列の状態の変化を待つための排他制御
+    std::mutex mutex;
+
+    // 待ち行列の状態の変化の通知
+    std::condition_variable changed;
+
+    // 描画スレッド
+    std::thread thread;
+
+    //
+    // 待ち行列の状態の変化を待っている側に知らせる
+    //
+    void notify()
+    {
+      // 相手が条件を調べてから眠るまでの間に通知が失われないように一度ロックを取る
+      { std::lock_guard<std::mutex> lock{ mutex }; }
+
+      // 空くのを待つ送り手と届くのを待つ受け手が同時に眠ることはない
+      changed.notify_one();
+    }
+
+    //
+    // 描画スレッドの処理
+    //
+    void run()
+    {
+      // ウィンドウのコンテキストをこのスレッドで使う
+      glfwMakeContextCurrent(window.get());
+
+      Frame frame;
+      for (;;)
+      {
+        // フレームが届くか終了を要求されるまで眠って待つ
+        {
+          std::unique_lock<std::mutex> lock{ mutex };
+          changed.wait(lock, [this] { return !queue.empty() || !running.load(std::memory_order_acquire); });
+        }
+
+        // 送られたフレームを全て描画したら終了する
+        if (!queue.pop(frame)) break;
+
+        // 待ち行列が空いたことを送り手に知らせる
+        notify();
+
+        // 最新のマウスや矢印キーの値を取得する
+        window.acquireInput();
+
+        // メインスレッドで取得したサイズでビューポートを設定して描画関数を呼び出す
+        if (!frame.iconified) glViewport(0, 0, frame.viewport[0], frame.viewport[1]);
+        render(frame.packet);
+
+#if defined(IMGUI_VERSION)
+        // 複製した ImGui の描画リストを描画する
+        if (frame.drawData.Valid) ImGui_ImplOpenGL3_RenderDrawData(&frame.drawData);
+#endif
+
+        // フレームを表示する
+        window.present(frame.inputTime);
+      }
+
+      // コンテキストを解放する
+      glfwMakeContextCurrent(nullptr);
+    }
+
+  public:
+
+    ///
+    /// コンストラクタ.
+    ///
+    /// @param window 描画するウィンドウ, このスレッドでコンテキストがカレントになっていること.
+    /// @param render 描画スレッドで呼び出す描画関数.
+    ///
+    Renderer(Window& window, std::function<void(const Packet&)> render) :
+      window{ window },
+      render{ std::move(render) },
+      running{ true }
+    {
+#if defined(IMGUI_VERSION)
+      // ImGui のフォントテクスチャやシェーダはコンテキストを移す前に作っておく
+      ImGui_ImplOpenGL3_NewFrame();
+#endif
+
+      // マウスや矢印キーの値のスナップショットは描画スレッドで取得する
+      window.setAutoAcquire(false);
+
+      // コンテキストを描画スレッドに移す
+      glfwMakeContextCurrent(nullptr);
+      thread = std::thread(&Renderer::run, this);
+    }
+
+    ///
+    /// コピーコンストラクタは使用しない
+    ///
+    Renderer(const Renderer&) = delete;
+
+    ///
+    /// 代入演算子は使用しない
+    ///
+    Renderer& operator=(const Renderer&) = delete;
+
+    ///
+    /// デストラクタ.
+    ///
+    /// @note
+    /// 送ったフレームを全て描画してから描画スレッドを終了し, コンテキストをこのスレッドに戻す.
+    ///
+    virtual ~Renderer()
+    {
+      running.store(false, std::memory_order_release);
+      notify();
+      thread.join();
+      glfwMakeContextCurrent(window.get());
+      window.setAutoAcquire(true);
+    }
+
+    ///
+    /// フレームを描画スレッドに送る.
+    ///
+    /// @param packet このフレームのデータ.
+    ///
+    /// @note
+    /// メインスレッドで Window::swapBuffers() の代わりに呼び出す.
+    /// ImGui のフレームを完了して描画リストを複製し, 待ち行列が空くまで眠って待ってから送る.
+    ///
+    void submit(Packet packet)
+    {
+      auto frame{ capture(std::move(packet)) };
+
+      // 待ち行列が空くまで待つ
+      {
+        std::unique_lock<std::mutex> lock{ mutex };
+        changed.wait(lock, [this] { return !queue.full(); });
+      }
+
+      // 送り手はこのスレッドだけなので空いた待ち行列が再びいっぱいになることはない
+      queue.push(std::move(frame));
+      notify();
+    }
+
+    ///
+    /// 待ち行列が空いていればフレームを描画スレッドに送る.
+    ///
+    /// @param packet このフレームのデータ.
+    /// @return 待ち行列がいっぱいでフレームを捨てたときは false.
+    ///
+    /// @note
+    /// submit() と違って待たないので, 描画スレッドが表示の完了を待っている間はそのフレームを捨てる.
+    ///
+    bool trySubmit(Packet packet)
+    {
+      if (!queue.push(capture(std::move(packet)))) return false;
+      notify();
+      return true;
+    }
+
+  private:
+
+    //
+    // フレームのデータと ImGui の描画リストの複製をまとめる
+    //
+    Frame capture(Packet&& packet)
+    {
+      Frame frame;
+      frame.packet = std::move(packet);
+
+      // ウィンドウの状態はメインスレッドでしか調べられないのでここで取得しておく
+      frame.viewport = window.getFboSize();
+      frame.iconified = glfwGetWindowAttrib(window.get(), GLFW_ICONIFIED) != GLFW_FALSE;
+      frame.inputTime = window.getInputTime();
+
+#if defined(IMGUI_VERSION)
+      // ImGui のフレームを作成していればフレームを完了して描画データを複製する
+      if (window.getImGuiFrame())
+      {
+        ImGui::Render();
+        if (const auto* data{ ImGui::GetDrawData() })
+        {
+          frame.drawData = *data;
+          frame.drawData.CmdLists.clear();
+          for (const auto* list : data->CmdLists)
+          {
+            frame.drawList.emplace_back(list->CloneOutput());
+            frame.drawData.CmdLists.push_back(frame.drawList.back().get());
+          }
+        }
+      }
+#endif
+
+      return frame;
+    }
+  };
+
+  ///
+  /// 複数のウィンドウの描画スケジューラ.
+  ///
+  /// @tparam Packet メインスレッドから描画スレッドに送るフレームごとのデータの型, デフォルトコンストラクタとムーブ代入とコピーができること.
+  ///
+  /// @note
+  /// 二つ目以降のウィンドウは最初のウィンドウとコンテキストを共有して開き, add() で登録する.
+  /// ウィンドウごとに Renderer の描画スレッドを起動して, それぞれのスレッドでカラーバッファを入れ替えるので,
+  /// 垂直同期を待っているウィンドウが他のウィンドウの描画を止めることはない.
+  /// メインスレッドは operator bool() で全てのウィンドウのイベントを処理し, submit() で全てのウィンドウにフレームを送る.
+  /// 表示が追いつかないウィンドウにはそのフレームを送らずに捨てるので, 他のウィンドウは遅いウィンドウに合わせずに表示を続ける.
+  /// テクスチャやバッファは共有されるが, 頂点配列オブジェクトやフレームバッファオブジェクトは共有されないので,
+  /// 描画関数の中でウィンドウごとに作成する.
+  ///
+  template <typename Packet>
+  class Scheduler
+  {
+    // 描画関数
+    const std::function<void(Window&, const Packet&)> render;
+
+    // 描画するウィンドウ
+    std::vector<Window*> windows;
+
+    // ウィンドウごとの描画スレッド
+    std::vector<std::unique_ptr<Renderer<Packet>>> renderer;
+
+    // ウィンドウごとの表示が追いつかずに捨てたフレームの数
+    std::vector<std::uint64_t> dropped;
+
+  public:
+
+    ///
+    /// コンストラクタ.
+    ///
+    /// @param render 描画スレッドで呼び出す描画関数, 描画するウィンドウとフレームのデータを引数にとる.
+    ///
+    Scheduler(std::function<void(Window&, const Packet&)> render) :
+      render{ std::move(render) }
+    {
+    }
+
+    ///
+    /// コピーコンストラクタは使用しない
+    ///
+    Scheduler(const Scheduler&) = delete;
+
+    ///
+    /// 代入演算子は使用しない
+    ///
+    Scheduler& operator=(const Scheduler&) = delete;
+
+    ///
+    /// デストラクタ.
+    ///
+    /// @note
+    /// 後から登録したウィンドウから描画スレッドを終了し, 最初のウィンドウのコンテキストをこのスレッドに戻す.
+    ///
+    virtual ~Scheduler()
+    {
+      while (!renderer.empty()) renderer.pop_back();
+    }
+
+    ///
+    /// ウィンドウを登録して描画スレッドを起動する.
+    ///
+    /// @param window 描画するウィンドウ, Scheduler より後に破棄すること.
+    /// @return 登録したウィンドウの番号.
+    ///
+    /// @note
+    /// 描画スレッドが動いている間はメインスレッドで OpenGL の関数を呼び出してはいけないので,
+    /// リソースの作成を済ませてから全てのウィンドウを登録する.
+    ///
+    std::size_t add(Window& window)
+    {
+      // ウィンドウのコンテキストをカレントにして描画スレッドに移す
+      glfwMakeContextCurrent(window.get());
+      auto* const w{ &window };
+      renderer.emplace_back(std::make_unique<Renderer<Packet>>(window,
+        [this, w](const Packet& packet) { render(*w, packet); }));
+      windows.emplace_back(w);
+      dropped.emplace_back(0);
+      return windows.size() - 1;
+    }
+
+    ///
+    /// 全てのウィンドウのイベントを取得してループを継続すべきかどうか調べる.
+    ///
+    /// @return いずれかのウィンドウを閉じるべきなら false.
+    ///
+    explicit operator bool()
+    {
+      // イベントを一度だけ取り出す
+      glfwPollEvents();
+
+      // ウィンドウごとにイベントを処理する
+      bool result{ !windows.empty() };
+      for (auto* window : windows) if (!window->update()) result = false;
+      return result;
+    }
+
+    ///
+    /// 全てのウィンドウにフレームを送る.
+    ///
+    /// @param packet このフレームのデータ.
+    ///
+    /// @note
+    /// 描画スレッドの待ち行列がいっぱいのウィンドウにはこのフレームを送らない.
+    ///
+    void submit(const Packet& packet)
+    {
+      for (std::size_t i = 0; i < renderer.size(); ++i)
+      {
+        if (!renderer[i]->trySubmit(packet)) ++dropped[i];
+      }
+    }
+
+    ///
+    /// 登録したウィンドウの数を得る.
+    ///
+    /// @return 登録したウィンドウの数.
+    ///
+    auto size() const
+    {
+      return windows.size();
+    }
+
+    ///
+    /// 登録したウィンドウを得る.
+    ///
+    /// @param i ウィンドウの番号.
+    /// @return i 番目のウィンドウ.
+    ///
+    Window& getWindow(std::size_t i) const
+    {
+      return *windows[i];
+    }
+
+    ///
+    /// 表示が追いつかずに捨てたフレームの数を得る.
+    ///
+    /// @param i ウィンドウの番号.
+    /// @return i 番目のウィンドウで捨てたフレームの数.
+    ///
+    auto getDropped(std::size_t i) const
+    {
+      return dropped[i];
+    }
+  };
+
+  ///
+  /// 固定の時間間隔でのシミュレーションの更新.
+  ///
+  /// @note
+  /// 前のフレームからの経過時間を蓄積して, step ごとに更新関数を呼び出す.
+  /// 描画関数には蓄積した時間の残りを step で割った補間の係数を渡すので, 描画はフレームレートに,
+  /// シミュレーションは step に従う. 更新が描画より重くても, 一フレームに呼び出す更新関数の回数は
+  /// maxSteps までに制限するので, 遅れを取り戻そうとして更に遅れることはない.
+  ///
+  class Timestep
+  {
+    // 更新の時間間隔 [秒]
+    double step;
+
+    // 一フレームで更新する最大の回数
+    int maxSteps;
+
+    // 前のフレームの時刻
+    std::chrono::steady_clock::time_point last;
+
+    // まだ更新していない経過時間 [秒]
+    double accumulator;
+
+    // シミュレーションの時刻 [秒]
+    double time;
+
+    // 更新した回数
+    std::uint64_t count;
+
+    // 更新が間に合わずに捨てた時間 [秒]
+    double dropped;
+
+  public:
+
+    ///
+    /// コンストラクタ.
+    ///
+    /// @param step 更新の時間間隔 [秒], 正の値.
+    /// @param maxSteps 一フレームで更新する最大の回数, 1 以上.
+    ///
+    /// @note
+    /// step が 0 以下だと advance() が終わらず, maxSteps が 0 以下だと全ての時間を捨てるので,
+    /// デバッグビルドでは assert で止め, そうでなければ step は 1/60 秒, maxSteps は 1 にする.
+    ///
+    Timestep(double step = 1.0 / 60.0, int maxSteps = 5) :
+      step{ step > 0.0 ? step : 1.0 / 60.0 },
+      maxSteps{ maxSteps > 0 ? maxSteps : 1 }
+    {
+      assert(step > 0.0 && maxSteps > 0);
+      reset();
+    }
+
+    ///
+    /// シミュレーションの時刻を 0 に戻す.
+    ///
+    /// @note
+    /// 一時停止から再開するときにも呼び出すと, 停止していた間の時間を蓄積しない.
+    ///
+    void reset()
+    {
+      last = std::chrono::steady_clock::now();
+      accumulator = 0.0;
+      time = 0.0;
+      count = 0;
+      dropped = 0.0;
+    }
+
+    ///
+    /// 経過時間に応じてシミュレーションを更新する.
+    ///
+    /// @param update 更新関数, 更新の時間間隔 [秒] を引数にとる.
+    /// @return 前の更新から次の更新までの間の現在の位置 (0 以上 1 未満), 描画の補間の係数.
+    ///
+    template <typename Update>
+    double advance(Update&& update)
+    {
+      // 前のフレームからの経過時間を求める
+      const auto now{ std::chrono::steady_clock::now() };
+      auto delta{ std::chrono::duration<double>(now - last).count() };
+      last = now;
+
+      // 一フレームで更新する回数を超える遅れは捨てる
+      const auto limit{ step * maxSteps };
+      if (delta > limit)
+      {
+        dropped += delta - limit;
+        delta = limit;
+      }
+      accumulator += delta;
+
+      // 蓄積した時間を step ごとに更新する
+      while (accumulator >= step)
+      {
+        update(step);
+        accumulator -= step;
+        time += step;
+        ++count;
+      }
+
+      return accumulator / step;
+    }
+
+    ///
+    /// ウィンドウが開いている間シミュレーションの更新と描画を繰り返す.
+    ///
+    /// @param window 描画するウィンドウ.
+    /// @param update 更新関数, 更新の時間間隔 [秒] を引数にとる.
+    /// @param render 描画関数, 補間の係数を引数にとる.
+    ///
+    /// @note
+    /// Window::setIdleMode() で待機しているとその間の時間は maxSteps を超えた分だけ捨てるので,
+    /// シミュレーションを進めるなら render の中で Window::invalidate() を呼び出す.
+    ///
+    template <typename Update, typename Render>
+    void run(Window& window, Update&& update, Render&& render)
+    {
+      while (window)
+      {
+        render(advance(update));
+        window.swapBuffers();
+      }
+    }
+
+    ///
+    /// 更新の時間間隔を得る.
+    ///
+    /// @return 更新の時間間隔 [秒].
+    ///
+    auto getStep() const
+    {
+      return step;
+    }
+
+    ///
+    /// シミュレーションの時刻を得る.
+    ///
+    /// @return 最後に更新したシミュレーションの時刻 [秒].
+    ///
+    auto getTime() const
+    {
+      return time;
+    }
+
+    ///
+    /// 更新した回数を得る.
+    ///
+    /// @return reset() してから更新関数を呼び出した回数.
+    ///
+    auto getCount() const
+    {
+      return count;
+    }
+
+    ///
+    /// 更新が間に合わずに捨てた時間を得る.
+    ///
+    /// @return reset() してから maxSteps を超えたために捨てた時間 [秒].
+    ///
+    auto getDropped() const
+    {
+      return dropped;
+    }
+  };
+
+  ///
+  /// バックグラウンドで作成した OpenGL のリソース.
+  ///
+  /// @tparam T 作成したリソースの型.
+  ///
+  /// @note
+  /// Loader::submit() が返す. ワーカーの処理が完了すると OpenGL のフェンスが設定され,
+  /// ready() が true になった後は描画スレッドでリソースを使うことができる.
+  ///
+  template <typename T>
+  class Job
+  {
+    friend class GgApp;
+
+    // 作成したリソース
+    T value;
+
+    // ワーカーのコンテキストで処理の完了後に挿入したフェンス
+    std::atomic<GLsync> fence;
+
+    // フェンスの設定を待つための排他制御
+    mutable std::mutex mutex;
+
+    // フェンスの設定の通知
+    mutable std::condition_variable published;
+
+    // ワーカーの処理で発生した例外
+    std::exception_ptr error;
+
+  public:
+
+    ///
+    /// コンストラクタ.
+    ///
+    Job() :
+      value{},
+      fence{ nullptr }
+    {
+    }
+
+    ///
+    /// デストラクタ.
+    ///
+    /// @note
+    /// リソースを共有するいずれかのコンテキストがカレントのときに破棄する.
+    ///
+    virtual ~Job()
+    {
+      if (const auto sync{ fence.load(std::memory_order_acquire) }) glDeleteSync(sync);
+    }
+
+    ///
+    /// 処理が完了してリソースが使えるかどうか調べる.
+    ///
+    /// @return 描画スレッドでリソースが使えるなら true.
+    ///
+    /// @note
+    /// フェンスの状態を待たずに調べるので描画スレッドを止めない.
+    ///
+    bool ready() const
+    {
+      const auto sync{ fence.load(std::memory_order_acquire) };
+      if (!sync) return false;
+      const auto status{ glClientWaitSync(sync, 0, 0) };
+      return status == GL_ALREADY_SIGNALED || status == GL_CONDITION_SATISFIED;
+    }
+
+    ///
+    /// 処理が完了するまで待つ.
+    ///
+    /// @note
+    /// ワーカーがフェンスを設定するまで眠って待ち, その後 GPU の処理の完了を待つ.
+    ///
+    void wait() const
+    {
+      // ワーカーの処理が終わってフェンスが設定されるまで待つ
+      GLsync sync;
+      {
+        std::unique_lock<std::mutex> lock{ mutex };
+        published.wait(lock, [this] { return fence.load(std::memory_order_acquire) != nullptr; });
+        sync = fence.load(std::memory_order_acquire);
+      }
+
+      // フェンスが通過するまで待つ (1 秒ごとにタイムアウトするが完了するまで待ち続ける)
+      constexpr GLuint64 timeout{ 1000000000 };
+      while (glClientWaitSync(sync, GL_SYNC_FLUSH_COMMANDS_BIT, timeout) == GL_TIMEOUT_EXPIRED);
+    }
+
+    ///
+    /// 作成したリソースを取り出す.
+    ///
+    /// @return 作成したリソースの参照.
+    ///
+    /// @note
+    /// 処理が完了していなければ完了するまで待ち, ワーカーで例外が発生していればここで送出する.
+    ///
+    const T& get() const
+    {
+      wait();
+      if (error) std::rethrow_exception(error);
+      return value;
+    }
+  };
+
+  ///
+  /// コンテキストを共有するワーカーのプール.
+  ///
+  /// @note
+  /// 指定したウィンドウとリソースを共有する非表示のウィンドウをワーカーの数だけ作り,
+  /// それぞれのコンテキストをカレントにしたスレッドで submit() された処理を実行する.
+  /// バッファオブジェクト, テクスチャ, シェーダのプログラムオブジェクトは共有されるが,
+  /// 頂点配列オブジェクト (GgShape) やフレームバッファオブジェクトは共有されないので描画スレッドで作る.
+  /// コンストラクタとデストラクタはメインスレッドで呼び出す.
+  ///
+  class Loader
+  {
+    // リソースを共有するウィンドウ
+    const Window& window;
+
+    // ワーカーのコンテキストを持つ非表示のウィンドウ
+    std::vector<GLFWwindow*> context;
+
+    // ワーカーのスレッド
+    std::vector<std::thread> worker;
+
+    // 実行待ちの処理
+    std::deque<std::function<void()>> task;
+
+    // 実行待ちの処理の排他制御
+    std::mutex mutex;
+
+    // 実行待ちの処理の追加の通知
+    std::condition_variable condition;
+
+    // ワーカーを終了するなら true
+    bool stopping;
+
+    //
+    // ワーカーの処理
+    //
+    void run(GLFWwindow* window)
+    {
+      // 共有するコンテキストをこのスレッドで使う
+      glfwMakeContextCurrent(window);
+
+#if defined(DEBUG) && !defined(__APPLE__) && !defined(GL_GLES_PROTOTYPES)
+      // ワーカーのコンテキストでもエラーをデバッグ出力で表示する
+      ggDebugOutput(GL_DEBUG_SEVERITY_LOW);
+#endif
+
+      for (;;)
+      {
+        std::function<void()> job;
+
+        {
+          // 実行待ちの処理を取り出す
+          std::unique_lock<std::mutex> lock{ mutex };
+          condition.wait(lock, [this] { return stopping || !task.empty(); });
+          if (task.empty()) break;
+          job = std::move(task.front());
+          task.pop_front();
+        }
+
+        // 処理を実行する
+        job();
+      }
+
+      // コンテキストを解放する
+      glfwMakeContextCurrent(nullptr);
+    }
+
+  public:
+
+    ///
+    /// コンストラクタ.
+    ///
+    /// @param window リソースを共有するウィンドウ.
+    /// @param count ワーカーの数.
+    ///
+    Loader(const Window& window, int count = 1) :
+      window{ window },
+      stopping{ false }
+    {
+      // 非表示のウィンドウを作る
+      glfwWindowHint(GLFW_VISIBLE, GLFW_FALSE);
+      for (int i = 0; i < count; ++i)
+      {
+        auto* const hidden{ glfwCreateWindow(1, 1, "", nullptr, window.get()) };
+        if (!hidden) break;
+        context.emplace_back(hidden);
+      }
+      glfwWindowHint(GLFW_VISIBLE, GLFW_TRUE);
+
+      // 共有するコンテキストが作れなければエラー
+      if (context.empty()) throw std::runtime_error("Unable to create a shared context.");
+
+      // ワーカーを起動する
+      for (auto* hidden : context) worker.emplace_back(&Loader::run, this, hidden);
+    }
+
+    ///
+    /// コピーコンストラクタは使用しない
+    ///
+    Loader(const Loader&) = delete;
+
+    ///
+    /// 代入演算子は使用しない
+    ///
+    Loader& operator=(const Loader&) = delete;
+
+    ///
+    /// デストラクタ.
+    ///
+    /// @note
+    /// 実行待ちの処理を全て実行してからワーカーを終了する.
+    ///
+    virtual ~Loader()
+    {
+      {
+        std::lock_guard<std::mutex> lock{ mutex };
+        stopping = true;
+      }
+      condition.notify_all();
+      for (auto& w : worker) w.join();
+      for (auto* hidden : context) glfwDestroyWindow(hidden);
+    }
+
+    ///
+    /// 処理をワーカーで実行する.
+    ///
+    /// @param func ワーカーのコンテキストで実行する関数, 作成したリソースを返す.
+    /// @return 処理の完了とリソースを保持する Job のポインタ.
+    ///
+    /// @note
+    /// func の実行後にフェンスを挿入して glFlush() するので, Job::ready() が true なら描画スレッドで使える.
+    /// 描画スレッドでは使う前にリソースを結合し直す.
+    /// 完了するとウィンドウの Window::invalidate() を呼び出してイベントの待機を終わらせる.
+    ///
+    template <typename Func>
+    auto submit(Func func)
+    {
+      using Result = std::invoke_result_t<Func>;
+      using Value = std::conditional_t<std::is_void_v<Result>, bool, Result>;
+      auto job{ std::make_shared<Job<Value>>() };
+
+      {
+        std::lock_guard<std::mutex> lock{ mutex };
+        task.emplace_back([this, job, func = std::move(func)]() mutable
+        {
+          try
+          {
+            if constexpr (std::is_void_v<Result>)
+            {
+              func();
+              job->value = true;
+            }
+            else
+            {
+              job->value = func();
+            }
+          }
+          catch (...)
+          {
+            job->error = std::current_exception();
+          }
+
+          // 処理の完了を描画スレッドに知らせるフェンスを挿入する
+          const auto sync{ glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0) };
+          glFlush();
+          {
+            std::lock_guard<std::mutex> lock{ job->mutex };
+            job->fence.store(sync, std::memory_order_release);
+          }
+          job->published.notify_all();
+
+          // イベントを待っていれば完了したリソースを使うために描画し直す
+          window.invalidate();
+        });
+      }
+      condition.notify_one();
+
+      return job;
+    }
+  };
+
+  ///
+  /// フレームのプロファイラ.
+  ///
+  /// @note
+  /// GG_PROFILE_SCOPE() で CPU の区間, GG_PROFILE_GPU_SCOPE() で GPU の区間を計測し,
+  /// draw() で ImGui のウィンドウにタイムラインを表示する. 記録は exportChromeTrace() で
+  /// Chrome のトレース形式 (chrome://tracing や Perfetto で開ける) の JSON に書き出せる.
+  /// CPU の区間はスレッドごとのリングバッファにロックせずに記録する.
+  /// GPU の区間はタイマクエリで計測し, OpenGL のコンテキストを持つスレッドで collect() したときに記録する.
+  /// 区間の名前には文字列リテラルなど寿命がプログラムの終了まで続く文字列を使う.
+  ///
+  class Profiler
+  {
+  public:
+
+    ///
+    /// 記録した区間.
+    ///
+    struct Event
+    {
+      /// 区間の名前
+      const char* name;
+
+      /// 開始時刻 (ns)
+      std::int64_t begin;
+
+      /// 終了時刻 (ns)
+      std::int64_t end;
+
+      /// 入れ子の深さ
+      std::uint32_t depth;
+    };
+
+    ///
+    /// スレッドごとの記録.
+    ///
+    /// @note
+    /// 記録するスレッドだけが書き込み, 他のスレッドは snapshot() で複製して読み出す.
+    ///
+    class Track
+    {
+      friend class Profiler;
+
+      // リングバッファの要素
+      struct Slot
+      {
+        std::atomic<const char*> name;
+        std::atomic<std::int64_t> begin;
+        std::atomic<std::int64_t> end;
+        std::atomic<std::uint32_t> depth;
+      };
+
+      // 記録した区間のリングバッファ
+      std::unique_ptr<Slot[]> slot;
+
+      // 書き込みを開始した区間の数
+      std::atomic<std::uint64_t> started;
+
+      // 書き込みを完了した区間の数
+      std::atomic<std::uint64_t> count;
+
+      // 記録するスレッドの名前
+      std::string name;
+
+      // 記録するスレッドで計測中の区間の入れ子の深さ
+      std::uint32_t depth;
+
+      //
+      // 区間を記録する
+      //
+      void push(const char* name, std::int64_t begin, std::int64_t end, std::uint32_t depth);
+
+    public:
+
+      ///
+      /// コンストラクタ.
+      ///
+      /// @param name スレッドの名前.
+      ///
+      Track(const std::string& name);
+
+      ///
+      /// 記録した区間を複製する.
+      ///
+      /// @return 古いものから順に並べた区間, 読み出している間に上書きされたものは含まない.
+      ///
+      std::vector<Event> snapshot() const;
+
+      ///
+      /// スレッドの名前を得る.
+      ///
+      /// @return スレッドの名前.
+      ///
+      const std::string& getName() const
+      {
+        return name;
+      }
+    };
+
+    ///
+    /// CPU の区間を計測する.
+    ///
+    /// @note
+    /// コンストラクタからデストラクタまでの時間をこのスレッドの記録に追加する.
+    ///
+    class Scope
+    {
+      // 記録先, 記録しなければ nullptr
+      Track* track;
+
+      // 区間の名前
+      const char* name;
+
+      // 開始時刻
+      std::int64_t begin;
+
+    public:
+
+      ///
+      /// コンストラクタ.
+      ///
+      /// @param name 区間の名前.
+      ///
+      Scope(const char* name) :
+        track{ enabled.load(std::memory_order_relaxed) ? &getTrack() : nullptr },
+        name{ name },
+        begin{ 0 }
+      {
+        if (track)
+        {
+          ++track->depth;
+          begin = now();
+        }
+      }
+
+      ///
+      /// デストラクタ.
+      ///
+      ~Scope()
+      {
+        if (track) track->push(name, begin, now(), --track->depth);
+      }
+
+      Scope(const Scope&) = delete;
+      Scope& operator=(const Scope&) = delete;
+    };
+
+    ///
+    /// GPU の区間を計測する.
+    ///
+    /// @note
+    /// コンストラクタとデストラクタでタイムスタンプのクエリを発行する.
+    /// OpenGL のコンテキストがカレントのスレッドで使う.
+    ///
+    class GpuScope
+    {
+      // 開始時刻のクエリの番号, 記録しなければ負
+      int query;
+
+    public:
+
+      ///
+      /// コンストラクタ.
+      ///
+      /// @param name 区間の名前.
+      ///
+      GpuScope(const char* name);
+
+      ///
+      /// デストラクタ.
+      ///
+      ~GpuScope();
+
+      GpuScope(const GpuScope&) = delete;
+      GpuScope& operator=(const GpuScope&) = delete;
+    };
+
+  private:
+
+    // 記録するなら true
+    static std::atomic<bool> enabled;
+
+    // 全てのスレッドの記録
+    static std::vector<std::unique_ptr<Track>> tracks;
+
+    // 記録の追加の排他制御
+    static std::mutex trackMutex;
+
+    // GPU の区間の記録
+    static std::unique_ptr<Track> gpuTrack;
+
+    // GPU の区間の計測
+    struct GpuQuery
+    {
+      // 区間の名前
+      const char* name;
+
+      // 開始時刻と終了時刻のタイムスタンプのクエリ
+      std::array<GLuint, 2> query;
+
+      // 入れ子の深さ
+      std::uint32_t depth;
+
+      // 終了時刻のクエリを発行していれば true
+      bool closed;
+    };
+
+    // 発行したタイムスタンプのクエリ
+    static std::vector<GpuQuery> gpuQuery;
+
+    // 結果を取り出していないクエリの先頭と次に使うクエリの番号
+    static std::size_t gpuHead, gpuTail;
+
+    // 計測中の GPU の区間の入れ子の深さ
+    static std::uint32_t gpuDepth;
+
+    // GPU のタイムスタンプを CPU の時刻に変換するときに加える値
+    static std::int64_t gpuOffset;
+
+    // GPU の区間を計測するコンテキスト, クエリはコンテキスト間で共有されない
+    static std::atomic<GLFWwindow*> gpuContext;
+
+    //
+    // このスレッドの記録を得る
+    //
+    static Track& getTrack();
+
+  public:
+
+    /// スレッドごとに記録する区間の数
+    static constexpr std::size_t capacity{ 1 << 14 };
+
+    /// 同時に結果を待つことのできる GPU の区間の数
+    static constexpr std::size_t gpuCapacity{ 256 };
+
+    ///
+    /// 計測に使う時刻を得る.
+    ///
+    /// @return 単調増加する時刻 (ns).
+    ///
+    static std::int64_t now()
+    {
+      return std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+    }
+
+    ///
+    /// 記録するかどうかを設定する.
+    ///
+    /// @param flag true なら記録する.
+    ///
+    static void setEnabled(bool flag)
+    {
+      enabled.store(flag, std::memory_order_relaxed);
+    }
+
+    ///
+    /// 記録しているかどうかを調べる.
+    ///
+    /// @return 記録していれば true.
+    ///
+    static bool isEnabled()
+    {
+      return enabled.load(std::memory_order_relaxed);
+    }
+
+    ///
+    /// このスレッドの名前を設定する.
+    ///
+    /// @param name タイムラインに表示するスレッドの名前.
+    ///
+    static void setThreadName(const std::string& name);
+
+    ///
+    /// 結果が得られた GPU の区間を記録する.
+    ///
+    /// @note
+    /// OpenGL のコンテキストがカレントのスレッドで毎フレーム呼び出す. Window::present() が呼び出している.
+    ///
+    static void collect();
+
+    ///
+    /// 全ての記録を複製する.
+    ///
+    /// @return スレッドの名前と記録した区間の組, GPU の記録は最後.
+    ///
+    static std::vector<std::pair<std::string, std::vector<Event>>> snapshot();
+
+    ///
+    /// 記録を Chrome のトレース形式の JSON ファイルに書き出す.
+    ///
+    /// @param path 書き出すファイルのパス.
+    /// @return 書き出しに成功したら true.
+    ///
+    static bool exportChromeTrace(const std::string& path);
+
+#if defined(IMGUI_VERSION)
+    ///
+    /// タイムラインを ImGui のウィンドウに表示する.
+    ///
+    /// @param open ウィンドウを閉じたときに false にする変数のポインタ.
+    ///
+    /// @note
+    /// ImGui のフレームを作成しているときに呼び出す.
+    ///
+    static void draw(bool* open = nullptr);
+#endif
+  };
+
+#if defined(GG_USE_OCULUS_RIFT)
+  ///
+  /// Oculus Rift 関連の処理.
+  ///
+  /// @note
+  /// Oculus Rift を操作するラッパークラス（シングルトン）.
+  ///
+  class Oculus
+  {
+    // Oculus Rift のセッション
+    ovrSession session;
+
+    // Oculus Rift の状態
+    ovrHmdDesc hmdDesc;
+
+    // Oculus Rift へのレンダリングに使う FBO
+    GLuint oculusFbo[ovrEye_Count];
+
+    // Oculus Rift のスクリーンのサイズ
+    GLfloat screen[ovrEye_Count][4];
+
+    // ミラー表示用の FBO
+    GLuint mirrorFbo;
+
+    // Oculus Rift のミラー表示を行うウィンドウ
+    const Window* window;
+
+#  if OVR_PRODUCT_VERSION > 0
+
+    // Oculus Rift に送る描画データ
+    ovrLayerEyeFov layerData;
+
+    // Oculus Rift にレンダリングするフレームの番号
+    long long frameIndex;
+
+    // Oculus Rift へのレンダリングに使う FBO のデプステクスチャ
+    GLuint oculusDepth[ovrEye_Count];
+
+    // ミラー表示用の FBO のサイズ
+    int mirrorWidth, mirrorHeight;
+
+    // ミラー表示用の FBO のカラーテクスチャ
+    ovrMirrorTexture mirrorTexture;
+
+    //
+    // グラフィックスカードのデフォルトの LUID を得る
+    //
+    static ovrGraphicsLuid GetDefaultAdapterLuid();
+
+    //
+    // グラフィックスカードの LUID の比較
+    //
+    static int Compare(const ovrGraphicsLuid& lhs, const ovrGraphicsLuid& rhs);
+
+#  else
+
+    // Oculus Rift に送る描画データ
+    ovrLayer_Union layerData;
+
+    // Oculus Rift のレンダリング情報
+    ovrEyeRenderDesc eyeRenderDesc[ovrEye_Count];
 
     // Oculus Rift の視点情報
     ovrPosef eyePose[ovrEye_Count];
@@ -1068,3 +2702,23 @@ public:
   };
 #endif
 };
+
+#if defined(GG_NO_PROFILER)
+#  define GG_PROFILE_SCOPE(name) ((void)0)
+#  define GG_PROFILE_GPU_SCOPE(name) ((void)0)
+#else
+#  define GG_PROFILE_CONCAT_(a, b) a##b
+#  define GG_PROFILE_CONCAT(a, b) GG_PROFILE_CONCAT_(a, b)
+///
+/// この行から現在のブロックの終わりまでを CPU の区間として計測する.
+///
+/// @param name 区間の名前の文字列リテラル.
+///
+#  define GG_PROFILE_SCOPE(name) const GgApp::Profiler::Scope GG_PROFILE_CONCAT(ggProfileScope, __LINE__){ name }
+///
+/// この行から現在のブロックの終わりまでを GPU の区間として計測する.
+///
+/// @param name 区間の名前の文字列リテラル.
+///
+#  define GG_PROFILE_GPU_SCOPE(name) const GgApp::Profiler::GpuScope GG_PROFILE_CONCAT(ggProfileGpuScope, __LINE__){ name }
+#endif
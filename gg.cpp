@@ -34,13 +34,29 @@ CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 /// @cond INCLUDE_OPENGL_FUNCTIONS
 
 // 標準ライブラリ
+#include <cstdint>
 #include <cfloat>
 #include <cstdlib>
+#include <cstring>
 #include <iostream>
 #include <fstream>
 #include <sstream>
 #include <limits>
 #include <map>
+#include <algorithm>
+#include <thread>
+#include <atomic>
+
+// SIMD 命令 (GG_NO_SIMD を定義すればスカラー演算を使う)
+#if !defined(GG_NO_SIMD)
+#  if defined(__SSE__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 1)
+#    define GG_USE_SSE
+#    include <xmmintrin.h>
+#  elif defined(__ARM_NEON) || defined(_M_ARM64)
+#    define GG_USE_NEON
+#    include <arm_neon.h>
+#  endif
+#endif
 
 /// @def Alias OBJ ファイルからテクスチャ座標も読み込むなら 1.
 #define READ_TEXTURE_COORDINATE_FROM_OBJ 0
@@ -2597,6 +2613,161 @@ void gg::ggInit()
 
   // 使用している GPU のバッファアライメントを調べる
   glGetIntegerv(GL_UNIFORM_BUFFER_OFFSET_ALIGNMENT, &ggBufferAlignment);
+
+#if defined(DEBUG) && !defined(__APPLE__) && !defined(GL_GLES_PROTOTYPES)
+  // デバッグビルドではエラーをデバッグ出力で表示する
+  ggDebugOutput(GL_DEBUG_SEVERITY_LOW);
+#endif
+}
+
+/// @cond
+
+// いずれかのコンテキストでデバッグ出力を使っていれば true
+static std::atomic<bool> ggDebugOutputEnabled{ false };
+
+// このスレッドで開始しているデバッグ出力の区間
+static thread_local std::vector<std::string> ggDebugGroupStack;
+
+/// @endcond
+
+#if !defined(__APPLE__) && !defined(GL_GLES_PROTOTYPES)
+/// @cond
+//
+// デバッグ出力のメッセージを表示する
+//
+static void APIENTRY ggDebugMessage(GLenum source, GLenum type, GLuint id, GLenum severity,
+  GLsizei length, const GLchar* message, const void*)
+{
+  // メッセージの発生源
+  const char* sourceName{ "OTHER" };
+  switch (source)
+  {
+  case GL_DEBUG_SOURCE_API: sourceName = "API"; break;
+  case GL_DEBUG_SOURCE_WINDOW_SYSTEM: sourceName = "WINDOW_SYSTEM"; break;
+  case GL_DEBUG_SOURCE_SHADER_COMPILER: sourceName = "SHADER_COMPILER"; break;
+  case GL_DEBUG_SOURCE_THIRD_PARTY: sourceName = "THIRD_PARTY"; break;
+  case GL_DEBUG_SOURCE_APPLICATION: sourceName = "APPLICATION"; break;
+  }
+
+  // メッセージの種類
+  const char* typeName{ "OTHER" };
+  switch (type)
+  {
+  case GL_DEBUG_TYPE_ERROR: typeName = "ERROR"; break;
+  case GL_DEBUG_TYPE_DEPRECATED_BEHAVIOR: typeName = "DEPRECATED_BEHAVIOR"; break;
+  case GL_DEBUG_TYPE_UNDEFINED_BEHAVIOR: typeName = "UNDEFINED_BEHAVIOR"; break;
+  case GL_DEBUG_TYPE_PORTABILITY: typeName = "PORTABILITY"; break;
+  case GL_DEBUG_TYPE_PERFORMANCE: typeName = "PERFORMANCE"; break;
+  case GL_DEBUG_TYPE_MARKER: typeName = "MARKER"; break;
+  case GL_DEBUG_TYPE_PUSH_GROUP: typeName = "PUSH_GROUP"; break;
+  case GL_DEBUG_TYPE_POP_GROUP: typeName = "POP_GROUP"; break;
+  }
+
+  // メッセージの重要度
+  const char* severityName{ "NOTIFICATION" };
+  switch (severity)
+  {
+  case GL_DEBUG_SEVERITY_HIGH: severityName = "HIGH"; break;
+  case GL_DEBUG_SEVERITY_MEDIUM: severityName = "MEDIUM"; break;
+  case GL_DEBUG_SEVERITY_LOW: severityName = "LOW"; break;
+  }
+
+  // メッセージを発生した区間とともに表示する
+  std::cerr << "GL " << severityName << " " << sourceName << " " << typeName << " (" << id << "): "
+    << std::string(message, length < 0 ? std::char_traits<GLchar>::length(message) : static_cast<std::size_t>(length));
+  if (!ggDebugGroupStack.empty())
+  {
+    std::cerr << " [in ";
+    for (std::size_t i = 0; i < ggDebugGroupStack.size(); ++i)
+      std::cerr << (i > 0 ? " / " : "") << ggDebugGroupStack[i];
+    std::cerr << "]";
+  }
+  std::cerr << std::endl;
+}
+
+//
+// カレントのコンテキストでデバッグ出力を使っているかどうか調べる
+//
+//   デバッグ出力の設定はコンテキストごとなので, ggInit() を呼んでいないコンテキストでは使われていない
+//
+static bool ggDebugOutputCurrent()
+{
+  if (!ggDebugOutputEnabled.load(std::memory_order_relaxed)) return false;
+
+  GLvoid* callback{ nullptr };
+  glGetPointerv(GL_DEBUG_CALLBACK_FUNCTION, &callback);
+  return callback == reinterpret_cast<GLvoid*>(ggDebugMessage);
+}
+/// @endcond
+
+//
+// OpenGL のデバッグ出力を設定する
+//
+bool gg::ggDebugOutput(GLenum severity, bool synchronous)
+{
+  // デバッグ出力が使えなければ戻る
+  if (!glDebugMessageCallback || !glDebugMessageControl) return false;
+
+  // デバッグ出力を止めるなら
+  if (severity == GL_NONE)
+  {
+    glDisable(GL_DEBUG_OUTPUT);
+    glDebugMessageCallback(nullptr, nullptr);
+    ggDebugOutputEnabled = false;
+    return true;
+  }
+
+  // 指定した重要度以上のメッセージだけを表示する
+  constexpr GLenum level[]{ GL_DEBUG_SEVERITY_HIGH, GL_DEBUG_SEVERITY_MEDIUM, GL_DEBUG_SEVERITY_LOW, GL_DEBUG_SEVERITY_NOTIFICATION };
+  bool enable{ true };
+  for (const auto s : level)
+  {
+    glDebugMessageControl(GL_DONT_CARE, GL_DONT_CARE, s, 0, nullptr, enable ? GL_TRUE : GL_FALSE);
+    if (s == severity) enable = false;
+  }
+
+  // デバッグ出力を有効にする
+  glEnable(GL_DEBUG_OUTPUT);
+  if (synchronous) glEnable(GL_DEBUG_OUTPUT_SYNCHRONOUS); else glDisable(GL_DEBUG_OUTPUT_SYNCHRONOUS);
+  glDebugMessageCallback(ggDebugMessage, nullptr);
+  ggDebugOutputEnabled = true;
+
+  return true;
+}
+#endif
+
+//
+// OpenGL のオブジェクトにデバッグ出力で使う名前を付ける
+//
+void gg::ggObjectLabel(GLenum identifier, GLuint name, const std::string& label)
+{
+#if !defined(__APPLE__) && !defined(GL_GLES_PROTOTYPES)
+  if (ggDebugOutputEnabled && glObjectLabel && name != 0)
+    glObjectLabel(identifier, name, static_cast<GLsizei>(label.size()), label.c_str());
+#endif
+}
+
+//
+// デバッグ出力の区間を開始する
+//
+gg::GgDebugGroup::GgDebugGroup(const std::string& name)
+{
+  ggDebugGroupStack.emplace_back(name);
+#if !defined(__APPLE__) && !defined(GL_GLES_PROTOTYPES)
+  if (ggDebugOutputEnabled && glPushDebugGroup)
+    glPushDebugGroup(GL_DEBUG_SOURCE_APPLICATION, 0, static_cast<GLsizei>(name.size()), name.c_str());
+#endif
+}
+
+//
+// デバッグ出力の区間を終了する
+//
+gg::GgDebugGroup::~GgDebugGroup()
+{
+#if !defined(__APPLE__) && !defined(GL_GLES_PROTOTYPES)
+  if (ggDebugOutputEnabled && glPopDebugGroup) glPopDebugGroup();
+#endif
+  ggDebugGroupStack.pop_back();
 }
 
 //
@@ -2608,6 +2779,11 @@ void gg::ggInit()
 //
 void gg::_ggError(const std::string& name, unsigned int line)
 {
+#if !defined(__APPLE__) && !defined(GL_GLES_PROTOTYPES)
+  // このコンテキストでデバッグ出力を使っていればエラーはそちらで表示されるので同期しない
+  if (ggDebugOutputCurrent()) return;
+#endif
+
   const GLenum error{ glGetError() };
 
   if (error != GL_NO_ERROR)
@@ -2709,10 +2885,26 @@ void gg::_ggFBOError(const std::string& name, unsigned int line)
 //
 void gg::GgMatrix::projection(GLfloat* c, const GLfloat* a, const GLfloat* b) const
 {
+#if defined(GG_USE_SSE)
+  // a の列ベクトルを b の要素で重み付けして足し合わせる
+  auto t{ _mm_mul_ps(_mm_loadu_ps(a + 0), _mm_set1_ps(b[0])) };
+  t = _mm_add_ps(t, _mm_mul_ps(_mm_loadu_ps(a + 4), _mm_set1_ps(b[1])));
+  t = _mm_add_ps(t, _mm_mul_ps(_mm_loadu_ps(a + 8), _mm_set1_ps(b[2])));
+  t = _mm_add_ps(t, _mm_mul_ps(_mm_loadu_ps(a + 12), _mm_set1_ps(b[3])));
+  _mm_storeu_ps(c, t);
+#elif defined(GG_USE_NEON)
+  // a の列ベクトルを b の要素で重み付けして足し合わせる
+  auto t{ vmulq_n_f32(vld1q_f32(a + 0), b[0]) };
+  t = vmlaq_n_f32(t, vld1q_f32(a + 4), b[1]);
+  t = vmlaq_n_f32(t, vld1q_f32(a + 8), b[2]);
+  t = vmlaq_n_f32(t, vld1q_f32(a + 12), b[3]);
+  vst1q_f32(c, t);
+#else
   for (int i = 0; i < 4; ++i)
   {
     c[i] = a[0 + i] * b[0] + a[4 + i] * b[1] + a[8 + i] * b[2] + a[12 + i] * b[3];
   }
+#endif
 }
 
 //
@@ -2720,12 +2912,46 @@ void gg::GgMatrix::projection(GLfloat* c, const GLfloat* a, const GLfloat* b) co
 //
 void gg::GgMatrix::multiply(GLfloat* c, const GLfloat* a, const GLfloat* b) const
 {
+#if defined(GG_USE_SSE)
+  // a の列ベクトル
+  const auto a0{ _mm_loadu_ps(a + 0) };
+  const auto a1{ _mm_loadu_ps(a + 4) };
+  const auto a2{ _mm_loadu_ps(a + 8) };
+  const auto a3{ _mm_loadu_ps(a + 12) };
+
+  // c の列ベクトルは a の列ベクトルを b の列の要素で重み付けしたものの和
+  for (int k = 0; k < 16; k += 4)
+  {
+    auto t{ _mm_mul_ps(a0, _mm_set1_ps(b[k + 0])) };
+    t = _mm_add_ps(t, _mm_mul_ps(a1, _mm_set1_ps(b[k + 1])));
+    t = _mm_add_ps(t, _mm_mul_ps(a2, _mm_set1_ps(b[k + 2])));
+    t = _mm_add_ps(t, _mm_mul_ps(a3, _mm_set1_ps(b[k + 3])));
+    _mm_storeu_ps(c + k, t);
+  }
+#elif defined(GG_USE_NEON)
+  // a の列ベクトル
+  const auto a0{ vld1q_f32(a + 0) };
+  const auto a1{ vld1q_f32(a + 4) };
+  const auto a2{ vld1q_f32(a + 8) };
+  const auto a3{ vld1q_f32(a + 12) };
+
+  // c の列ベクトルは a の列ベクトルを b の列の要素で重み付けしたものの和
+  for (int k = 0; k < 16; k += 4)
+  {
+    auto t{ vmulq_n_f32(a0, b[k + 0]) };
+    t = vmlaq_n_f32(t, a1, b[k + 1]);
+    t = vmlaq_n_f32(t, a2, b[k + 2]);
+    t = vmlaq_n_f32(t, a3, b[k + 3]);
+    vst1q_f32(c + k, t);
+  }
+#else
   for (int i = 0; i < 16; ++i)
   {
     int j = i & 3, k = i & ~3;
 
     c[i] = a[0 + j] * b[k + 0] + a[4 + j] * b[k + 1] + a[8 + j] * b[k + 2] + a[12 + j] * b[k + 3];
   }
+#endif
 }
 
 //
@@ -2903,11 +3129,98 @@ gg::GgMatrix& gg::GgMatrix::loadTranspose(const GLfloat* marray)
   return *this;
 }
 
+#if defined(GG_USE_SSE)
+//
+// __m128 に行優先で格納した 2×2 行列の積 a × b
+//
+static inline __m128 ggMat2Mul(__m128 a, __m128 b)
+{
+  return _mm_add_ps(
+    _mm_mul_ps(a, _mm_shuffle_ps(b, b, _MM_SHUFFLE(3, 0, 3, 0))),
+    _mm_mul_ps(_mm_shuffle_ps(a, a, _MM_SHUFFLE(2, 3, 0, 1)), _mm_shuffle_ps(b, b, _MM_SHUFFLE(1, 2, 1, 2))));
+}
+
+//
+// __m128 に行優先で格納した 2×2 行列の余因子行列と行列の積 adj(a) × b
+//
+static inline __m128 ggMat2AdjMul(__m128 a, __m128 b)
+{
+  return _mm_sub_ps(
+    _mm_mul_ps(_mm_shuffle_ps(a, a, _MM_SHUFFLE(0, 0, 3, 3)), b),
+    _mm_mul_ps(_mm_shuffle_ps(a, a, _MM_SHUFFLE(2, 2, 1, 1)), _mm_shuffle_ps(b, b, _MM_SHUFFLE(1, 0, 3, 2))));
+}
+
+//
+// __m128 に行優先で格納した 2×2 行列と余因子行列の積 a × adj(b)
+//
+static inline __m128 ggMat2MulAdj(__m128 a, __m128 b)
+{
+  return _mm_sub_ps(
+    _mm_mul_ps(a, _mm_shuffle_ps(b, b, _MM_SHUFFLE(0, 3, 0, 3))),
+    _mm_mul_ps(_mm_shuffle_ps(a, a, _MM_SHUFFLE(2, 3, 0, 1)), _mm_shuffle_ps(b, b, _MM_SHUFFLE(1, 2, 1, 2))));
+}
+#endif
+
 //
 // 変換行列：逆行列を設定する
 //
 gg::GgMatrix& gg::GgMatrix::loadInvert(const GLfloat* marray)
 {
+#if defined(GG_USE_SSE)
+  // 2×2 の小行列に分けて余因子から逆行列を求める
+  const auto m0{ _mm_loadu_ps(marray + 0) };
+  const auto m1{ _mm_loadu_ps(marray + 4) };
+  const auto m2{ _mm_loadu_ps(marray + 8) };
+  const auto m3{ _mm_loadu_ps(marray + 12) };
+
+  // 小行列 | A B |
+  //        | C D |
+  const auto a{ _mm_movelh_ps(m0, m1) };
+  const auto b{ _mm_movehl_ps(m1, m0) };
+  const auto c{ _mm_movelh_ps(m2, m3) };
+  const auto d{ _mm_movehl_ps(m3, m2) };
+
+  // 小行列の行列式 (|A|, |B|, |C|, |D|)
+  const auto det{ _mm_sub_ps(
+    _mm_mul_ps(_mm_shuffle_ps(m0, m2, _MM_SHUFFLE(2, 0, 2, 0)), _mm_shuffle_ps(m1, m3, _MM_SHUFFLE(3, 1, 3, 1))),
+    _mm_mul_ps(_mm_shuffle_ps(m0, m2, _MM_SHUFFLE(3, 1, 3, 1)), _mm_shuffle_ps(m1, m3, _MM_SHUFFLE(2, 0, 2, 0)))) };
+  const auto detA{ _mm_shuffle_ps(det, det, _MM_SHUFFLE(0, 0, 0, 0)) };
+  const auto detB{ _mm_shuffle_ps(det, det, _MM_SHUFFLE(1, 1, 1, 1)) };
+  const auto detC{ _mm_shuffle_ps(det, det, _MM_SHUFFLE(2, 2, 2, 2)) };
+  const auto detD{ _mm_shuffle_ps(det, det, _MM_SHUFFLE(3, 3, 3, 3)) };
+
+  // adj(D) × C と adj(A) × B
+  const auto dc{ ggMat2AdjMul(d, c) };
+  const auto ab{ ggMat2AdjMul(a, b) };
+
+  // 逆行列の小行列の余因子行列
+  auto x{ _mm_sub_ps(_mm_mul_ps(detD, a), ggMat2Mul(b, dc)) };
+  auto w{ _mm_sub_ps(_mm_mul_ps(detA, d), ggMat2Mul(c, ab)) };
+  auto y{ _mm_sub_ps(_mm_mul_ps(detB, c), ggMat2MulAdj(d, ab)) };
+  auto z{ _mm_sub_ps(_mm_mul_ps(detC, b), ggMat2MulAdj(a, dc)) };
+
+  // 行列式 |M| = |A||D| + |B||C| - tr(adj(A) B adj(D) C)
+  auto tr{ _mm_mul_ps(ab, _mm_shuffle_ps(dc, dc, _MM_SHUFFLE(3, 1, 2, 0))) };
+  tr = _mm_add_ps(tr, _mm_shuffle_ps(tr, tr, _MM_SHUFFLE(2, 3, 0, 1)));
+  tr = _mm_add_ps(tr, _mm_shuffle_ps(tr, tr, _MM_SHUFFLE(1, 0, 3, 2)));
+  const auto detM{ _mm_sub_ps(_mm_add_ps(_mm_mul_ps(detA, detD), _mm_mul_ps(detB, detC)), tr) };
+
+  // 正則でなければ何もしない
+  if (_mm_cvtss_f32(detM) == 0.0f) return *this;
+
+  // 行列式で割って符号を合わせる
+  const auto r{ _mm_div_ps(_mm_setr_ps(1.0f, -1.0f, -1.0f, 1.0f), detM) };
+  x = _mm_mul_ps(x, r);
+  y = _mm_mul_ps(y, r);
+  z = _mm_mul_ps(z, r);
+  w = _mm_mul_ps(w, r);
+
+  // 余因子行列を並べ替えて格納する
+  _mm_storeu_ps(data() + 0, _mm_shuffle_ps(x, y, _MM_SHUFFLE(1, 3, 1, 3)));
+  _mm_storeu_ps(data() + 4, _mm_shuffle_ps(x, y, _MM_SHUFFLE(0, 2, 0, 2)));
+  _mm_storeu_ps(data() + 8, _mm_shuffle_ps(z, w, _MM_SHUFFLE(1, 3, 1, 3)));
+  _mm_storeu_ps(data() + 12, _mm_shuffle_ps(z, w, _MM_SHUFFLE(0, 2, 0, 2)));
+#else
   GLfloat lu[20];
   GLfloat* plu[4];
 
@@ -2982,6 +3295,7 @@ gg::GgMatrix& gg::GgMatrix::loadInvert(const GLfloat* marray)
       (*this)[i * 4 + k] /= plu[i][i];
     }
   }
+#endif
 
   return *this;
 }
@@ -3017,6 +3331,227 @@ gg::GgMatrix& gg::GgMatrix::loadNormal(const GLfloat* marray)
   return *this;
 }
 
+//
+// 変換行列：種類に応じた方法で逆行列を設定する
+//
+gg::GgMatrix& gg::GgMatrix::loadInvert(const GLfloat* marray, Kind kind)
+{
+  switch (kind)
+  {
+  case Rigid:
+  {
+    // 平行移動量
+    const auto tx{ marray[12] };
+    const auto ty{ marray[13] };
+    const auto tz{ marray[14] };
+
+    // 回転部分は転置し, 平行移動量には逆回転を施して符号を反転する
+    *this =
+    {
+      marray[ 0],
+      marray[ 4],
+      marray[ 8],
+      0.0f,
+
+      marray[ 1],
+      marray[ 5],
+      marray[ 9],
+      0.0f,
+
+      marray[ 2],
+      marray[ 6],
+      marray[10],
+      0.0f,
+
+      -(marray[ 0] * tx + marray[ 1] * ty + marray[ 2] * tz),
+      -(marray[ 4] * tx + marray[ 5] * ty + marray[ 6] * tz),
+      -(marray[ 8] * tx + marray[ 9] * ty + marray[10] * tz),
+      1.0f
+    };
+    break;
+  }
+
+  case ScaleTranslate:
+  {
+    // 拡大率が 0 なら何もしない
+    if (marray[0] == 0.0f || marray[5] == 0.0f || marray[10] == 0.0f) break;
+
+    // 拡大率の逆数
+    const auto sx{ 1.0f / marray[ 0] };
+    const auto sy{ 1.0f / marray[ 5] };
+    const auto sz{ 1.0f / marray[10] };
+
+    *this =
+    {
+      sx,
+      0.0f,
+      0.0f,
+      0.0f,
+
+      0.0f,
+      sy,
+      0.0f,
+      0.0f,
+
+      0.0f,
+      0.0f,
+      sz,
+      0.0f,
+
+      -marray[12] * sx,
+      -marray[13] * sy,
+      -marray[14] * sz,
+      1.0f
+    };
+    break;
+  }
+
+  case Affine:
+  {
+    // 左上 3×3 の部分の余因子 (逆行列の行ベクトルに行列式を乗じたもの)
+    GLfloat r0[3], r1[3], r2[3];
+    ggCross(r0, marray + 4, marray + 8);
+    ggCross(r1, marray + 8, marray + 0);
+    ggCross(r2, marray + 0, marray + 4);
+
+    // 行列式
+    const auto det{ ggDot3(marray, r0) };
+    if (det == 0.0f) break;
+    const auto i{ 1.0f / det };
+
+    *this =
+    {
+      r0[0] * i,
+      r1[0] * i,
+      r2[0] * i,
+      0.0f,
+
+      r0[1] * i,
+      r1[1] * i,
+      r2[1] * i,
+      0.0f,
+
+      r0[2] * i,
+      r1[2] * i,
+      r2[2] * i,
+      0.0f,
+
+      -ggDot3(r0, marray + 12) * i,
+      -ggDot3(r1, marray + 12) * i,
+      -ggDot3(r2, marray + 12) * i,
+      1.0f
+    };
+    break;
+  }
+
+  default:
+    loadInvert(marray);
+    break;
+  }
+
+  return *this;
+}
+
+//
+// 変換行列：種類に応じた方法で法線変換行列を設定する
+//
+gg::GgMatrix& gg::GgMatrix::loadNormal(const GLfloat* marray, Kind kind)
+{
+  switch (kind)
+  {
+  case Rigid:
+    // 回転の余因子行列は回転自身
+    *this =
+    {
+      marray[ 0],
+      marray[ 1],
+      marray[ 2],
+      0.0f,
+
+      marray[ 4],
+      marray[ 5],
+      marray[ 6],
+      0.0f,
+
+      marray[ 8],
+      marray[ 9],
+      marray[10],
+      0.0f,
+
+      0.0f,
+      0.0f,
+      0.0f,
+      1.0f
+    };
+    break;
+
+  case ScaleTranslate:
+    // 対角行列の余因子行列は対角行列
+    *this =
+    {
+      marray[ 5] * marray[10],
+      0.0f,
+      0.0f,
+      0.0f,
+
+      0.0f,
+      marray[10] * marray[ 0],
+      0.0f,
+      0.0f,
+
+      0.0f,
+      0.0f,
+      marray[ 0] * marray[ 5],
+      0.0f,
+
+      0.0f,
+      0.0f,
+      0.0f,
+      1.0f
+    };
+    break;
+
+  default:
+    loadNormal(marray);
+    break;
+  }
+
+  return *this;
+}
+
+//
+// 変換行列：変換行列の種類を調べる
+//
+gg::GgMatrix::Kind gg::GgMatrix::getKind(GLfloat tolerance) const
+{
+  const auto* const m{ data() };
+
+  // 最下行が 0, 0, 0, 1 でなければ一般の変換行列
+  if (m[3] != 0.0f || m[7] != 0.0f || m[11] != 0.0f || m[15] != 1.0f) return General;
+
+  // 回転成分がなければ拡大縮小と平行移動だけの変換
+  if (m[1] == 0.0f && m[2] == 0.0f && m[4] == 0.0f &&
+    m[6] == 0.0f && m[8] == 0.0f && m[9] == 0.0f) return ScaleTranslate;
+
+  // 左上 3×3 の部分の列ベクトルが正規直交して右手系なら剛体変換
+  if (
+    fabs(ggDot3(m + 0, m + 0) - 1.0f) <= tolerance &&
+    fabs(ggDot3(m + 4, m + 4) - 1.0f) <= tolerance &&
+    fabs(ggDot3(m + 8, m + 8) - 1.0f) <= tolerance &&
+    fabs(ggDot3(m + 0, m + 4)) <= tolerance &&
+    fabs(ggDot3(m + 4, m + 8)) <= tolerance &&
+    fabs(ggDot3(m + 8, m + 0)) <= tolerance
+    )
+  {
+    GLfloat c[3];
+    ggCross(c, m + 0, m + 4);
+    if (ggDot3(c, m + 8) > 0.0f) return Rigid;
+  }
+
+  // それ以外はアフィン変換
+  return Affine;
+}
+
 //
 // 変換行列：ビュー変換行列を設定する
 //
@@ -3198,29 +3733,458 @@ gg::GgMatrix& gg::GgMatrix::loadPerspective(
   return *this;
 }
 
+/// @cond
+
 //
-// 四元数：GgQuaternion 型の四元数 p, q の積を r に求める
+// 一括変換：並列処理するときの一つのスレッドあたりの最小の要素数
 //
-void gg::GgQuaternion::multiply(GLfloat* r, const GLfloat* p, const GLfloat* q) const
+constexpr GLsizei ggParallelGrain{ 4096 };
+
+//
+// 一括変換：[0, count) の範囲を threads 個のスレッドに分割して func(first, last) を実行する
+//
+template <typename Func>
+static void ggParallelFor(GLsizei count, int threads, Func func)
 {
-  r[0] = p[1] * q[2] - p[2] * q[1] + p[0] * q[3] + p[3] * q[0];
-  r[1] = p[2] * q[0] - p[0] * q[2] + p[1] * q[3] + p[3] * q[1];
-  r[2] = p[0] * q[1] - p[1] * q[0] + p[2] * q[3] + p[3] * q[2];
-  r[3] = p[3] * q[3] - p[0] * q[0] - p[1] * q[1] - p[2] * q[2];
+  // 要素数に対してスレッド数が多すぎれば減らす
+  const auto maxThreads{ static_cast<int>(count / ggParallelGrain) };
+  if (threads > maxThreads) threads = maxThreads;
+
+  // 並列化しないときはこのスレッドで全部処理する
+  if (threads <= 1)
+  {
+    func(0, count);
+    return;
+  }
+
+  // 一つのスレッドが処理する要素数
+  const auto chunk{ (count + threads - 1) / threads };
+
+  // 最初の部分以外を別のスレッドで処理する
+  std::vector<std::thread> worker;
+  worker.reserve(threads - 1);
+  for (GLsizei first = chunk; first < count; first += chunk)
+  {
+    worker.emplace_back(func, first, std::min(first + chunk, count));
+  }
+
+  // 最初の部分はこのスレッドで処理する
+  func(0, std::min(chunk, count));
+
+  // 全てのスレッドの終了を待つ
+  for (auto& w : worker) w.join();
 }
 
 //
-// 四元数：GgQuaternion 型の四元数 q が表す変換行列を m に求める
+// 一括変換：GgVector 型の配列の [first, last) の範囲の要素に変換行列 m を乗じる
 //
-void gg::GgQuaternion::toMatrix(GLfloat* m, const GLfloat* q) const
+//   normal が true なら m の左上 3×3 の部分だけを使い w 成分は 0 にする
+//
+static void ggTransformAoS(const GLfloat* m, const gg::GgVector* src, gg::GgVector* dst,
+  GLsizei first, GLsizei last, bool normal)
 {
-  const auto xx{ q[0] * q[0] * 2.0f };
-  const auto yy{ q[1] * q[1] * 2.0f };
-  const auto zz{ q[2] * q[2] * 2.0f };
-  const auto xy{ q[0] * q[1] * 2.0f };
-  const auto yz{ q[1] * q[2] * 2.0f };
-  const auto zx{ q[2] * q[0] * 2.0f };
-  const auto xw{ q[0] * q[3] * 2.0f };
+#if defined(GG_USE_SSE)
+  // m の列ベクトル
+  const auto c0{ _mm_setr_ps(m[0], m[1], m[2], normal ? 0.0f : m[3]) };
+  const auto c1{ _mm_setr_ps(m[4], m[5], m[6], normal ? 0.0f : m[7]) };
+  const auto c2{ _mm_setr_ps(m[8], m[9], m[10], normal ? 0.0f : m[11]) };
+  const auto c3{ normal ? _mm_setzero_ps() : _mm_loadu_ps(m + 12) };
+
+  for (GLsizei i = first; i < last; ++i)
+  {
+    const auto v{ _mm_loadu_ps(src[i].data()) };
+    auto t{ _mm_mul_ps(c0, _mm_shuffle_ps(v, v, _MM_SHUFFLE(0, 0, 0, 0))) };
+    t = _mm_add_ps(t, _mm_mul_ps(c1, _mm_shuffle_ps(v, v, _MM_SHUFFLE(1, 1, 1, 1))));
+    t = _mm_add_ps(t, _mm_mul_ps(c2, _mm_shuffle_ps(v, v, _MM_SHUFFLE(2, 2, 2, 2))));
+    t = _mm_add_ps(t, _mm_mul_ps(c3, _mm_shuffle_ps(v, v, _MM_SHUFFLE(3, 3, 3, 3))));
+    _mm_storeu_ps(dst[i].data(), t);
+  }
+#elif defined(GG_USE_NEON)
+  // m の列ベクトル
+  const auto w{ normal ? vdupq_n_f32(0.0f) : vld1q_f32(m + 12) };
+  const auto c0{ normal ? vsetq_lane_f32(0.0f, vld1q_f32(m + 0), 3) : vld1q_f32(m + 0) };
+  const auto c1{ normal ? vsetq_lane_f32(0.0f, vld1q_f32(m + 4), 3) : vld1q_f32(m + 4) };
+  const auto c2{ normal ? vsetq_lane_f32(0.0f, vld1q_f32(m + 8), 3) : vld1q_f32(m + 8) };
+
+  for (GLsizei i = first; i < last; ++i)
+  {
+    const auto& v{ src[i] };
+    auto t{ vmulq_n_f32(c0, v[0]) };
+    t = vmlaq_n_f32(t, c1, v[1]);
+    t = vmlaq_n_f32(t, c2, v[2]);
+    t = vmlaq_n_f32(t, w, v[3]);
+    vst1q_f32(dst[i].data(), t);
+  }
+#else
+  for (GLsizei i = first; i < last; ++i)
+  {
+    const auto v{ src[i] };
+    if (normal)
+    {
+      for (int j = 0; j < 3; ++j) dst[i][j] = m[0 + j] * v[0] + m[4 + j] * v[1] + m[8 + j] * v[2];
+      dst[i][3] = 0.0f;
+    }
+    else
+    {
+      for (int j = 0; j < 4; ++j) dst[i][j] = m[0 + j] * v[0] + m[4 + j] * v[1] + m[8 + j] * v[2] + m[12 + j] * v[3];
+    }
+  }
+#endif
+}
+
+//
+// 一括変換：n 個の成分の配列に分けて格納したベクトルの [first, last) の範囲の要素に変換行列 m を乗じる
+//
+//   n が 4 なら m 全体を使い, 3 なら m の左上 3×3 の部分だけを使う
+//
+static void ggTransformSoA(const GLfloat* m, const GLfloat* const* src, GLfloat* const* dst,
+  GLsizei first, GLsizei last, int n)
+{
+  auto i{ first };
+
+#if defined(GG_USE_SSE)
+  // 4 要素ずつ処理する
+  for (; i + 4 <= last; i += 4)
+  {
+    const __m128 v[]
+    {
+      _mm_loadu_ps(src[0] + i),
+      _mm_loadu_ps(src[1] + i),
+      _mm_loadu_ps(src[2] + i),
+      n > 3 ? _mm_loadu_ps(src[3] + i) : _mm_setzero_ps()
+    };
+
+    for (int j = 0; j < n; ++j)
+    {
+      auto t{ _mm_mul_ps(_mm_set1_ps(m[0 + j]), v[0]) };
+      t = _mm_add_ps(t, _mm_mul_ps(_mm_set1_ps(m[4 + j]), v[1]));
+      t = _mm_add_ps(t, _mm_mul_ps(_mm_set1_ps(m[8 + j]), v[2]));
+      if (n > 3) t = _mm_add_ps(t, _mm_mul_ps(_mm_set1_ps(m[12 + j]), v[3]));
+      _mm_storeu_ps(dst[j] + i, t);
+    }
+  }
+#elif defined(GG_USE_NEON)
+  // 4 要素ずつ処理する
+  for (; i + 4 <= last; i += 4)
+  {
+    const float32x4_t v[]
+    {
+      vld1q_f32(src[0] + i),
+      vld1q_f32(src[1] + i),
+      vld1q_f32(src[2] + i),
+      n > 3 ? vld1q_f32(src[3] + i) : vdupq_n_f32(0.0f)
+    };
+
+    for (int j = 0; j < n; ++j)
+    {
+      auto t{ vmulq_n_f32(v[0], m[0 + j]) };
+      t = vmlaq_n_f32(t, v[1], m[4 + j]);
+      t = vmlaq_n_f32(t, v[2], m[8 + j]);
+      if (n > 3) t = vmlaq_n_f32(t, v[3], m[12 + j]);
+      vst1q_f32(dst[j] + i, t);
+    }
+  }
+#endif
+
+  // 残りの要素を処理する
+  for (; i < last; ++i)
+  {
+    const GLfloat v[]{ src[0][i], src[1][i], src[2][i], n > 3 ? src[3][i] : 0.0f };
+
+    for (int j = 0; j < n; ++j)
+    {
+      dst[j][i] = m[0 + j] * v[0] + m[4 + j] * v[1] + m[8 + j] * v[2] + m[12 + j] * v[3];
+    }
+  }
+}
+
+/// @endcond
+
+//
+// 一括変換：複数の位置ベクトルに同じ変換行列を乗じる (AoS)
+//
+void gg::ggTransformPoints(const GgMatrix& m, const GgVector* src, GgVector* dst,
+  GLsizei count, int threads)
+{
+  ggParallelFor(count, threads, [&](GLsizei first, GLsizei last)
+  {
+    ggTransformAoS(m.data(), src, dst, first, last, false);
+  });
+}
+
+//
+// 一括変換：複数の位置ベクトルに同じ変換行列を乗じる (SoA)
+//
+void gg::ggTransformPoints(const GgMatrix& m, const GLfloat* const* src, GLfloat* const* dst,
+  GLsizei count, int threads)
+{
+  ggParallelFor(count, threads, [&](GLsizei first, GLsizei last)
+  {
+    ggTransformSoA(m.data(), src, dst, first, last, 4);
+  });
+}
+
+//
+// 一括変換：複数の法線ベクトルに同じ法線変換行列を乗じる (AoS)
+//
+void gg::ggTransformNormals(const GgMatrix& m, const GgVector* src, GgVector* dst,
+  GLsizei count, int threads)
+{
+  ggParallelFor(count, threads, [&](GLsizei first, GLsizei last)
+  {
+    ggTransformAoS(m.data(), src, dst, first, last, true);
+  });
+}
+
+//
+// 一括変換：複数の法線ベクトルに同じ法線変換行列を乗じる (SoA)
+//
+void gg::ggTransformNormals(const GgMatrix& m, const GLfloat* const* src, GLfloat* const* dst,
+  GLsizei count, int threads)
+{
+  ggParallelFor(count, threads, [&](GLsizei first, GLsizei last)
+  {
+    ggTransformSoA(m.data(), src, dst, first, last, 3);
+  });
+}
+
+//
+// 一括変換：複数の変換行列に同じ変換行列を左から乗じる
+//
+void gg::ggMultiplyMatrices(const GgMatrix& m, const GgMatrix* src, GgMatrix* dst,
+  GLsizei count, int threads)
+{
+  ggParallelFor(count, threads, [&](GLsizei first, GLsizei last)
+  {
+    for (GLsizei i = first; i < last; ++i) dst[i] = m * src[i];
+  });
+}
+
+//
+// 一括変換：複数のモデル変換行列からモデルビュー投影変換行列を求める
+//
+void gg::ggModelviewProjection(const GgMatrix& mp, const GgMatrix& mv, const GgMatrix* model, GgMatrix* mvp,
+  GLsizei count, int threads)
+{
+  // 投影変換行列とビュー変換行列の積は先に求めておく
+  ggMultiplyMatrices(mp * mv, model, mvp, count, threads);
+}
+
+//
+// SoA 形式のベクトル：データの数を変更する
+//
+void gg::GgVectorSoA::resize(GLsizei count)
+{
+  // 要素数の単位に切り上げた各成分の配列の要素数
+  const auto newPadded{ (count + width - 1) / width * width };
+
+  if (newPadded != padded)
+  {
+    // 新しい領域を 0 で初期化して確保する
+    std::vector<Block> newStorage(static_cast<size_t>(newPadded / width) * 4, Block{});
+
+    // 既存のデータを成分ごとに複写する
+    const auto n{ std::min(this->count, count) };
+    for (int i = 0; i < 4; ++i)
+    {
+      std::copy(get(i), get(i) + n, newStorage.data()->v + static_cast<size_t>(newPadded) * i);
+    }
+
+    storage.swap(newStorage);
+    padded = newPadded;
+  }
+  else if (count < this->count)
+  {
+    // 減った要素は 0 にしておく
+    for (int i = 0; i < 4; ++i) std::fill(get(i) + count, get(i) + this->count, 0.0f);
+  }
+
+  this->count = count;
+}
+
+//
+// SoA 形式のベクトル：GgVector 型の配列からデータを読み込む
+//
+void gg::GgVectorSoA::load(const GgVector* v, GLsizei count)
+{
+  resize(count);
+
+  // 成分ごとに配列に振り分ける
+  GLfloat* const s[]{ get(0), get(1), get(2), get(3) };
+  for (GLsizei i = 0; i < count; ++i)
+  {
+    s[0][i] = v[i][0];
+    s[1][i] = v[i][1];
+    s[2][i] = v[i][2];
+    s[3][i] = v[i][3];
+  }
+}
+
+//
+// SoA 形式のベクトル：GgVector 型の配列にデータを書き出す
+//
+void gg::GgVectorSoA::store(GgVector* v) const
+{
+  // 成分ごとの配列から取り出す
+  const GLfloat* const s[]{ get(0), get(1), get(2), get(3) };
+  for (GLsizei i = 0; i < count; ++i)
+  {
+    v[i] = GgVector{ s[0][i], s[1][i], s[2][i], s[3][i] };
+  }
+}
+
+//
+// SoA 形式のベクトル：それぞれの 3 要素の内積を求める
+//
+void gg::ggDot3(const GgVectorSoA& a, const GgVectorSoA& b, GLfloat* c)
+{
+  const auto count{ a.getCount() };
+  const GLfloat* const ax{ a.get(0) }, * const ay{ a.get(1) }, * const az{ a.get(2) };
+  const GLfloat* const bx{ b.get(0) }, * const by{ b.get(1) }, * const bz{ b.get(2) };
+  GLsizei i{ 0 };
+
+#if defined(GG_USE_SSE)
+  for (; i + 4 <= count; i += 4)
+  {
+    auto t{ _mm_mul_ps(_mm_load_ps(ax + i), _mm_load_ps(bx + i)) };
+    t = _mm_add_ps(t, _mm_mul_ps(_mm_load_ps(ay + i), _mm_load_ps(by + i)));
+    t = _mm_add_ps(t, _mm_mul_ps(_mm_load_ps(az + i), _mm_load_ps(bz + i)));
+    _mm_storeu_ps(c + i, t);
+  }
+#endif
+
+  for (; i < count; ++i) c[i] = ax[i] * bx[i] + ay[i] * by[i] + az[i] * bz[i];
+}
+
+//
+// SoA 形式のベクトル：それぞれの 3 要素の外積を求める
+//
+void gg::ggCross(GgVectorSoA& c, const GgVectorSoA& a, const GgVectorSoA& b)
+{
+  // 出力先が入力と同じときは一時領域に求める
+  if (&c == &a || &c == &b)
+  {
+    GgVectorSoA t;
+    ggCross(t, a, b);
+    c = std::move(t);
+    return;
+  }
+
+  c.resize(a.getCount());
+
+  // パディングの部分も 0 同士の演算なのでまとめて処理する
+  const auto padded{ a.getPaddedCount() };
+  const GLfloat* const ax{ a.get(0) }, * const ay{ a.get(1) }, * const az{ a.get(2) };
+  const GLfloat* const bx{ b.get(0) }, * const by{ b.get(1) }, * const bz{ b.get(2) };
+  GLfloat* const cx{ c.get(0) }, * const cy{ c.get(1) }, * const cz{ c.get(2) }, * const cw{ c.get(3) };
+
+#if defined(GG_USE_SSE)
+  for (GLsizei i = 0; i < padded; i += 4)
+  {
+    const auto x0{ _mm_load_ps(ax + i) }, y0{ _mm_load_ps(ay + i) }, z0{ _mm_load_ps(az + i) };
+    const auto x1{ _mm_load_ps(bx + i) }, y1{ _mm_load_ps(by + i) }, z1{ _mm_load_ps(bz + i) };
+    _mm_store_ps(cx + i, _mm_sub_ps(_mm_mul_ps(y0, z1), _mm_mul_ps(z0, y1)));
+    _mm_store_ps(cy + i, _mm_sub_ps(_mm_mul_ps(z0, x1), _mm_mul_ps(x0, z1)));
+    _mm_store_ps(cz + i, _mm_sub_ps(_mm_mul_ps(x0, y1), _mm_mul_ps(y0, x1)));
+    _mm_store_ps(cw + i, _mm_setzero_ps());
+  }
+#else
+  for (GLsizei i = 0; i < padded; ++i)
+  {
+    cx[i] = ay[i] * bz[i] - az[i] * by[i];
+    cy[i] = az[i] * bx[i] - ax[i] * bz[i];
+    cz[i] = ax[i] * by[i] - ay[i] * bx[i];
+    cw[i] = 0.0f;
+  }
+#endif
+}
+
+//
+// SoA 形式のベクトル：それぞれの 3 要素の長さを求める
+//
+void gg::ggLength3(const GgVectorSoA& a, GLfloat* c)
+{
+  const auto count{ a.getCount() };
+  const GLfloat* const ax{ a.get(0) }, * const ay{ a.get(1) }, * const az{ a.get(2) };
+  GLsizei i{ 0 };
+
+#if defined(GG_USE_SSE)
+  for (; i + 4 <= count; i += 4)
+  {
+    const auto x{ _mm_load_ps(ax + i) }, y{ _mm_load_ps(ay + i) }, z{ _mm_load_ps(az + i) };
+    auto t{ _mm_mul_ps(x, x) };
+    t = _mm_add_ps(t, _mm_mul_ps(y, y));
+    t = _mm_add_ps(t, _mm_mul_ps(z, z));
+    _mm_storeu_ps(c + i, _mm_sqrt_ps(t));
+  }
+#endif
+
+  for (; i < count; ++i) c[i] = sqrtf(ax[i] * ax[i] + ay[i] * ay[i] + az[i] * az[i]);
+}
+
+//
+// SoA 形式のベクトル：それぞれの 3 要素を正規化する
+//
+void gg::ggNormalize3(GgVectorSoA& a)
+{
+  // パディングの部分は長さが 0 なのでそのまま残る
+  const auto padded{ a.getPaddedCount() };
+  GLfloat* const ax{ a.get(0) }, * const ay{ a.get(1) }, * const az{ a.get(2) };
+
+#if defined(GG_USE_SSE)
+  const auto zero{ _mm_setzero_ps() };
+  for (GLsizei i = 0; i < padded; i += 4)
+  {
+    const auto x{ _mm_load_ps(ax + i) }, y{ _mm_load_ps(ay + i) }, z{ _mm_load_ps(az + i) };
+    auto t{ _mm_mul_ps(x, x) };
+    t = _mm_add_ps(t, _mm_mul_ps(y, y));
+    t = _mm_add_ps(t, _mm_mul_ps(z, z));
+
+    // 長さが 0 の要素は 1 で割る
+    const auto nonzero{ _mm_cmpgt_ps(t, zero) };
+    const auto l{ _mm_or_ps(_mm_and_ps(nonzero, _mm_sqrt_ps(t)), _mm_andnot_ps(nonzero, _mm_set1_ps(1.0f))) };
+    _mm_store_ps(ax + i, _mm_div_ps(x, l));
+    _mm_store_ps(ay + i, _mm_div_ps(y, l));
+    _mm_store_ps(az + i, _mm_div_ps(z, l));
+  }
+#else
+  for (GLsizei i = 0; i < padded; ++i)
+  {
+    const auto t{ ax[i] * ax[i] + ay[i] * ay[i] + az[i] * az[i] };
+    if (t > 0.0f)
+    {
+      const auto l{ sqrtf(t) };
+      ax[i] /= l;
+      ay[i] /= l;
+      az[i] /= l;
+    }
+  }
+#endif
+}
+
+//
+// 四元数：GgQuaternion 型の四元数 p, q の積を r に求める
+//
+void gg::GgQuaternion::multiply(GLfloat* r, const GLfloat* p, const GLfloat* q) const
+{
+  r[0] = p[1] * q[2] - p[2] * q[1] + p[0] * q[3] + p[3] * q[0];
+  r[1] = p[2] * q[0] - p[0] * q[2] + p[1] * q[3] + p[3] * q[1];
+  r[2] = p[0] * q[1] - p[1] * q[0] + p[2] * q[3] + p[3] * q[2];
+  r[3] = p[3] * q[3] - p[0] * q[0] - p[1] * q[1] - p[2] * q[2];
+}
+
+//
+// 四元数：GgQuaternion 型の四元数 q が表す変換行列を m に求める
+//
+void gg::GgQuaternion::toMatrix(GLfloat* m, const GLfloat* q) const
+{
+  const auto xx{ q[0] * q[0] * 2.0f };
+  const auto yy{ q[1] * q[1] * 2.0f };
+  const auto zz{ q[2] * q[2] * 2.0f };
+  const auto xy{ q[0] * q[1] * 2.0f };
+  const auto yz{ q[1] * q[2] * 2.0f };
+  const auto zx{ q[2] * q[0] * 2.0f };
+  const auto xw{ q[0] * q[3] * 2.0f };
   const auto yw{ q[1] * q[3] * 2.0f };
   const auto zw{ q[2] * q[3] * 2.0f };
 
@@ -3258,10 +4222,10 @@ void gg::GgQuaternion::toQuaternion(GLfloat* q, const GLfloat* a) const
 //
 void gg::GgQuaternion::slerp(GLfloat* p, const GLfloat* q, const GLfloat* r, GLfloat t) const
 {
-  const auto qr{ ggDot3(q, r) };
+  const auto qr{ ggDot4(q, r) };
   const auto ss{ 1.0f - qr * qr };
 
-  if (ss == 0.0f)
+  if (ss <= 0.0f)
   {
     if (p != q)
     {
@@ -3286,6 +4250,181 @@ void gg::GgQuaternion::slerp(GLfloat* p, const GLfloat* q, const GLfloat* r, GLf
   }
 }
 
+/// @cond
+
+//
+// 四元数の一括補間：補間の方法
+//
+enum class ggInterpolation
+{
+  Nlerp,                              // 正規化線形補間
+  SlerpApprox,                        // 補間パラメータを補正した正規化線形補間
+  Slerp                               // 球面線形補間
+};
+
+//
+// 四元数の一括補間：近似的な球面線形補間のために補間パラメータを補正する
+//
+//   d 二つの四元数の内積の絶対値
+//   t 補間パラメータ
+//
+static inline GLfloat ggSlerpApproxParameter(GLfloat d, GLfloat t)
+{
+  const auto a{ 1.0904f + d * (-3.2452f + d * (3.55645f - d * 1.43519f)) };
+  const auto b{ 0.848013f + d * (-1.06021f + d * 0.215638f) };
+  const auto h{ t - 0.5f };
+  const auto k{ a * h * h + b };
+  return t + t * h * (t - 1.0f) * k;
+}
+
+//
+// 四元数の一括補間：一つの四元数を補間する
+//
+static void ggInterpolate(GLfloat* p, const GLfloat* q, const GLfloat* r, GLfloat t,
+  ggInterpolation method, bool shortest)
+{
+  // 短い方の経路を選ぶときは終点の符号を合わせる
+  auto d{ gg::ggDot4(q, r) };
+  const auto s{ shortest && d < 0.0f ? -1.0f : 1.0f };
+  d *= s;
+
+  // 始点と終点の重み
+  GLfloat t0, t1;
+
+  if (method == ggInterpolation::Slerp && 1.0f - d * d > 0.0f)
+  {
+    const auto sp{ sqrtf(1.0f - d * d) };
+    const auto ph{ acosf(d) };
+    t0 = sinf(ph * (1.0f - t)) / sp;
+    t1 = sinf(ph * t) / sp;
+  }
+  else
+  {
+    // 近似するときは補間パラメータを補正する
+    if (method == ggInterpolation::SlerpApprox) t = ggSlerpApproxParameter(fabsf(d), t);
+    t0 = 1.0f - t;
+    t1 = t;
+  }
+  t1 *= s;
+
+  // 補間して正規化する
+  GLfloat v[4];
+  for (int i = 0; i < 4; ++i) v[i] = q[i] * t0 + r[i] * t1;
+  const auto l{ gg::ggLength4(v) };
+  const auto n{ l > 0.0f ? 1.0f / l : 0.0f };
+  for (int i = 0; i < 4; ++i) p[i] = v[i] * n;
+}
+
+//
+// 四元数の一括補間：SoA 形式の四元数の配列を補間する
+//
+static void ggInterpolate(gg::GgVectorSoA& p, const gg::GgVectorSoA& q, const gg::GgVectorSoA& r,
+  const GLfloat* t, ggInterpolation method, bool shortest)
+{
+  const auto count{ q.getCount() };
+  if (&p != &q && &p != &r) p.resize(count);
+
+  const GLfloat* const qs[]{ q.get(0), q.get(1), q.get(2), q.get(3) };
+  const GLfloat* const rs[]{ r.get(0), r.get(1), r.get(2), r.get(3) };
+  GLfloat* const ps[]{ p.get(0), p.get(1), p.get(2), p.get(3) };
+  GLsizei i{ 0 };
+
+#if defined(GG_USE_SSE)
+  // 三角関数を使わない補間は 4 要素ずつ処理する
+  if (method != ggInterpolation::Slerp)
+  {
+    const auto zero{ _mm_setzero_ps() };
+    const auto one{ _mm_set1_ps(1.0f) };
+    const auto half{ _mm_set1_ps(0.5f) };
+    const auto sign{ _mm_set1_ps(-0.0f) };
+
+    for (; i + 4 <= count; i += 4)
+    {
+      const __m128 vq[]{ _mm_load_ps(qs[0] + i), _mm_load_ps(qs[1] + i), _mm_load_ps(qs[2] + i), _mm_load_ps(qs[3] + i) };
+      __m128 vr[]{ _mm_load_ps(rs[0] + i), _mm_load_ps(rs[1] + i), _mm_load_ps(rs[2] + i), _mm_load_ps(rs[3] + i) };
+      auto vt{ _mm_loadu_ps(t + i) };
+
+      // 内積
+      auto d{ _mm_mul_ps(vq[0], vr[0]) };
+      for (int j = 1; j < 4; ++j) d = _mm_add_ps(d, _mm_mul_ps(vq[j], vr[j]));
+
+      // 短い方の経路を選ぶときは内積が負の要素の終点の符号を反転する
+      if (shortest)
+      {
+        const auto s{ _mm_and_ps(d, sign) };
+        for (int j = 0; j < 4; ++j) vr[j] = _mm_xor_ps(vr[j], s);
+        d = _mm_xor_ps(d, s);
+      }
+
+      // 近似するときは補間パラメータを補正する
+      if (method == ggInterpolation::SlerpApprox)
+      {
+        const auto ad{ _mm_andnot_ps(sign, d) };
+        auto a{ _mm_sub_ps(_mm_set1_ps(3.55645f), _mm_mul_ps(ad, _mm_set1_ps(1.43519f))) };
+        a = _mm_add_ps(_mm_set1_ps(-3.2452f), _mm_mul_ps(ad, a));
+        a = _mm_add_ps(_mm_set1_ps(1.0904f), _mm_mul_ps(ad, a));
+        auto b{ _mm_add_ps(_mm_set1_ps(-1.06021f), _mm_mul_ps(ad, _mm_set1_ps(0.215638f))) };
+        b = _mm_add_ps(_mm_set1_ps(0.848013f), _mm_mul_ps(ad, b));
+        const auto h{ _mm_sub_ps(vt, half) };
+        const auto k{ _mm_add_ps(_mm_mul_ps(a, _mm_mul_ps(h, h)), b) };
+        vt = _mm_add_ps(vt, _mm_mul_ps(_mm_mul_ps(vt, h), _mm_mul_ps(_mm_sub_ps(vt, one), k)));
+      }
+
+      // 線形補間する
+      const auto t0{ _mm_sub_ps(one, vt) };
+      __m128 v[4];
+      for (int j = 0; j < 4; ++j) v[j] = _mm_add_ps(_mm_mul_ps(vq[j], t0), _mm_mul_ps(vr[j], vt));
+
+      // 正規化する (長さが 0 なら 0 のまま)
+      auto l{ _mm_mul_ps(v[0], v[0]) };
+      for (int j = 1; j < 4; ++j) l = _mm_add_ps(l, _mm_mul_ps(v[j], v[j]));
+      const auto nonzero{ _mm_cmpgt_ps(l, zero) };
+      l = _mm_or_ps(_mm_and_ps(nonzero, _mm_sqrt_ps(l)), _mm_andnot_ps(nonzero, one));
+      for (int j = 0; j < 4; ++j) _mm_store_ps(ps[j] + i, _mm_div_ps(v[j], l));
+    }
+  }
+#endif
+
+  // 残りの要素を一つずつ処理する
+  for (; i < count; ++i)
+  {
+    const GLfloat vq[]{ qs[0][i], qs[1][i], qs[2][i], qs[3][i] };
+    const GLfloat vr[]{ rs[0][i], rs[1][i], rs[2][i], rs[3][i] };
+    GLfloat v[4];
+    ggInterpolate(v, vq, vr, t[i], method, shortest);
+    for (int j = 0; j < 4; ++j) ps[j][i] = v[j];
+  }
+}
+
+/// @endcond
+
+//
+// 四元数の一括補間：SoA 形式の四元数の配列のそれぞれを球面線形補間する
+//
+void gg::ggSlerp(GgVectorSoA& p, const GgVectorSoA& q, const GgVectorSoA& r,
+  const GLfloat* t, bool shortest)
+{
+  ggInterpolate(p, q, r, t, ggInterpolation::Slerp, shortest);
+}
+
+//
+// 四元数の一括補間：SoA 形式の四元数の配列のそれぞれを近似的に球面線形補間する
+//
+void gg::ggSlerpApprox(GgVectorSoA& p, const GgVectorSoA& q, const GgVectorSoA& r,
+  const GLfloat* t, bool shortest)
+{
+  ggInterpolate(p, q, r, t, ggInterpolation::SlerpApprox, shortest);
+}
+
+//
+// 四元数の一括補間：SoA 形式の四元数の配列のそれぞれを正規化線形補間する
+//
+void gg::ggNlerp(GgVectorSoA& p, const GgVectorSoA& q, const GgVectorSoA& r,
+  const GLfloat* t, bool shortest)
+{
+  ggInterpolate(p, q, r, t, ggInterpolation::Nlerp, shortest);
+}
+
 //
 // 四元数：(x, y, z) を軸とし角度 a 回転する四元数を求める
 //
@@ -3933,6 +5072,11 @@ void gg::ggCreateNormalMap(
     break;
   }
 
+  // 法線は成分ごとに分けて求める
+  GgVectorSoA n(size);
+  GLfloat* const nx{ n.get(0) }, * const ny{ n.get(1) }, * const nw{ n.get(3) };
+  std::fill(n.get(2), n.get(2) + size, nz);
+
   // 法線マップの作成
   for (GLsizei i = 0; i < size; ++i)
   {
@@ -3944,15 +5088,15 @@ void gg::ggCreateNormalMap(
     const auto v1{ ((y + width) % size + x) * stride };
 
     // 隣接する画素との値の差を法線の成分に用いる
-    nmap[i][0] = static_cast<GLfloat>(hmap[u1] - hmap[u0]);
-    nmap[i][1] = static_cast<GLfloat>(hmap[v1] - hmap[v0]);
-    nmap[i][2] = nz;
-    nmap[i][3] = hmap[i * stride];
-
-    // 法線ベクトルを正規化する
-    ggNormalize3(nmap[i]);
+    nx[i] = static_cast<GLfloat>(hmap[u1] - hmap[u0]);
+    ny[i] = static_cast<GLfloat>(hmap[v1] - hmap[v0]);
+    nw[i] = hmap[i * stride];
   }
 
+  // 法線ベクトルをまとめて正規化する
+  ggNormalize3(n);
+  n.store(nmap.data());
+
   // 内部フォーマットが浮動小数点テクスチャでなければ [0,1] に正規化する
   if (
     internal != GL_RGB16F &&
@@ -4987,8 +6131,12 @@ GLuint gg::ggCreateShader(
       // シェーダプログラムをリンクする
       glLinkProgram(program);
 
-      // リンクに成功したらプログラムオブジェクト名を返す
-      if (printProgramInfoLog(program) != GL_FALSE) return program;
+      // リンクに成功したらデバッグ出力で使う名前を付けてプログラムオブジェクト名を返す
+      if (printProgramInfoLog(program) != GL_FALSE)
+      {
+        ggObjectLabel(GL_PROGRAM, program, vtext.empty() ? ftext : vtext);
+        return program;
+      }
     }
   }
 
@@ -5112,6 +6260,9 @@ GLuint gg::ggCreateComputeShader(const std::string& csrc, const std::string& cte
       glDeleteProgram(program);
       return 0;
     }
+
+    // デバッグ出力で使う名前を付ける
+    ggObjectLabel(GL_PROGRAM, program, ctext);
   }
 
   // プログラムオブジェクトを返す
@@ -5139,6 +6290,174 @@ GLuint gg::ggLoadComputeShader(const std::string& comp)
 }
 #endif
 
+#if !defined(__APPLE__) && !defined(GL_GLES_PROTOTYPES)
+/// @cond
+//
+// バッファオブジェクトを永続的にマップできるか調べる
+//
+//   Linux では glfwGetProcAddress() が存在しない関数にもポインタを返すので,
+//   OpenGL 4.4 以降か GL_ARB_buffer_storage があることを確かめる
+//
+static bool ggBufferStorageSupported()
+{
+  if (!glBufferStorage || !glMapBufferRange) return false;
+
+  GLint major{ 0 }, minor{ 0 };
+  glGetIntegerv(GL_MAJOR_VERSION, &major);
+  glGetIntegerv(GL_MINOR_VERSION, &minor);
+  if (major * 100 + minor * 10 >= 440) return true;
+
+  if (!glGetStringi) return false;
+  GLint n{ 0 };
+  glGetIntegerv(GL_NUM_EXTENSIONS, &n);
+  for (GLint i = 0; i < n; ++i)
+  {
+    const auto* const name{ reinterpret_cast<const char*>(glGetStringi(GL_EXTENSIONS, i)) };
+    if (name && std::string(name) == "GL_ARB_buffer_storage") return true;
+  }
+
+  return false;
+}
+/// @endcond
+#endif
+
+//
+// インスタンスのバッファ：コンストラクタ
+//
+gg::GgInstanceBuffer::GgInstanceBuffer(GLsizei capacity) :
+  buffer{ [] { GLuint buffer; glGenBuffers(1, &buffer); return buffer; } () },
+  capacity{ capacity },
+  mapped{ nullptr },
+  fence{},
+  segment{ 0 },
+  count{ 0 }
+{
+  // 全ての領域の大きさ
+  const auto size{ static_cast<GLsizeiptr>(sizeof(GgInstance)) * capacity * segments };
+
+  glBindBuffer(GL_ARRAY_BUFFER, buffer);
+
+#if !defined(__APPLE__) && !defined(GL_GLES_PROTOTYPES)
+  // 永続的にマップできればバッファに直接書き込む
+  if (ggBufferStorageSupported())
+  {
+    constexpr GLbitfield flags{ GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT };
+    glBufferStorage(GL_ARRAY_BUFFER, size, nullptr, flags | GL_DYNAMIC_STORAGE_BIT);
+    mapped = static_cast<GgInstance*>(glMapBufferRange(GL_ARRAY_BUFFER, 0, size, flags));
+  }
+  else
+#endif
+  {
+    glBufferData(GL_ARRAY_BUFFER, size, nullptr, GL_STREAM_DRAW);
+  }
+
+  // マップできなければ書き込み先を用意して glBufferSubData() で転送する
+  if (!mapped) staging.resize(capacity);
+
+  glBindBuffer(GL_ARRAY_BUFFER, 0);
+}
+
+//
+// インスタンスのバッファ：デストラクタ
+//
+gg::GgInstanceBuffer::~GgInstanceBuffer()
+{
+  for (const auto f : fence) if (f) glDeleteSync(f);
+  glBindBuffer(GL_ARRAY_BUFFER, 0);
+  glDeleteBuffers(1, &buffer);
+}
+
+//
+// インスタンスのバッファ：次の領域に切り替えて書き込み先を得る
+//
+gg::GgInstance* gg::GgInstanceBuffer::map()
+{
+  // 書き込んだ領域を使う描画の後にフェンスを挿入する
+  if (count > 0)
+  {
+    if (fence[segment]) glDeleteSync(fence[segment]);
+    fence[segment] = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+  }
+
+  // 次の領域を使った描画が完了するまで待つ
+  segment = (segment + 1) % segments;
+  if (fence[segment])
+  {
+    while (glClientWaitSync(fence[segment], GL_SYNC_FLUSH_COMMANDS_BIT, 1000000) == GL_TIMEOUT_EXPIRED);
+    glDeleteSync(fence[segment]);
+    fence[segment] = nullptr;
+  }
+  count = 0;
+
+  return mapped ? mapped + static_cast<std::size_t>(segment) * capacity : staging.data();
+}
+
+//
+// インスタンスのバッファ：書き込みを終了する
+//
+void gg::GgInstanceBuffer::unmap(GLsizei count)
+{
+  this->count = std::min(count, capacity);
+
+  // マップしていなければ書き込んだ領域を転送する
+  if (!mapped && this->count > 0)
+  {
+    glBindBuffer(GL_ARRAY_BUFFER, buffer);
+    glBufferSubData(GL_ARRAY_BUFFER, static_cast<GLintptr>(sizeof(GgInstance)) * segment * capacity,
+      static_cast<GLsizeiptr>(sizeof(GgInstance)) * this->count, staging.data());
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+  }
+}
+
+//
+// インスタンスのバッファ：頂点配列オブジェクトにインスタンスごとの頂点属性を設定する
+//
+void gg::GgInstanceBuffer::attach(GLuint base) const
+{
+  // 最初に読み出すインスタンスの位置
+  const auto* const origin{ static_cast<const char*>(0) + sizeof(GgInstance) * base };
+
+  glBindBuffer(GL_ARRAY_BUFFER, buffer);
+
+  // モデル変換行列は列ごとに 4 つの in 変数から入力する
+  for (GLuint i = 0; i < 4; ++i)
+  {
+    const GLuint location{ GgInstanceModelLocation + i };
+    glVertexAttribPointer(location, 4, GL_FLOAT, GL_FALSE, sizeof(GgInstance),
+      origin + offsetof(GgInstance, model) + sizeof(GLfloat) * 4 * i);
+    glVertexAttribDivisor(location, 1);
+    glEnableVertexAttribArray(location);
+  }
+
+  // 色
+  glVertexAttribPointer(GgInstanceColorLocation, 4, GL_FLOAT, GL_FALSE, sizeof(GgInstance),
+    origin + offsetof(GgInstance, color));
+  glVertexAttribDivisor(GgInstanceColorLocation, 1);
+  glEnableVertexAttribArray(GgInstanceColorLocation);
+
+  // 材質番号は整数のまま入力する
+  glVertexAttribIPointer(GgInstanceMaterialLocation, 1, GL_UNSIGNED_INT, sizeof(GgInstance),
+    origin + offsetof(GgInstance, material));
+  glVertexAttribDivisor(GgInstanceMaterialLocation, 1);
+  glEnableVertexAttribArray(GgInstanceMaterialLocation);
+
+  glBindBuffer(GL_ARRAY_BUFFER, 0);
+}
+
+//
+// 形状：インスタンス描画
+//
+void gg::GgShape::drawInstanced(GLsizei instances, GLint first, GLsizei count) const
+{
+  // 頂点配列オブジェクトを指定する
+  object->bind();
+
+#if defined(__APPLE__) || defined(GL_GLES_PROTOTYPES)
+  // baseInstance が使えなければ書き込んだ領域から読み出すように頂点属性を設定し直す
+  if (instance) instance->attach(instance->getBaseInstance());
+#endif
+}
+
 //
 // 点：データ作成
 //
@@ -5164,6 +6483,24 @@ void gg::GgPoints::draw(GLint first, GLsizei count) const
   glDrawArrays(getMode(), first, count > 0 ? count : getCount() - first);
 }
 
+//
+// 点：インスタンス描画
+//
+void gg::GgPoints::drawInstanced(GLsizei instances, GLint first, GLsizei count) const
+{
+  // 頂点配列オブジェクトを指定する
+  GgShape::drawInstanced(instances, first, count);
+
+  // 図形を描画する
+  const auto range{ getInstanceRange(instances) };
+  if (range[0] == 0) return;
+#if defined(__APPLE__) || defined(GL_GLES_PROTOTYPES)
+  glDrawArraysInstanced(getMode(), first, count > 0 ? count : getCount() - first, range[0]);
+#else
+  glDrawArraysInstancedBaseInstance(getMode(), first, count > 0 ? count : getCount() - first, range[0], range[1]);
+#endif
+}
+
 //
 // 三角形：データ作成
 //
@@ -5172,6 +6509,10 @@ void gg::GgTriangles::load(const GgVertex* vert, GLsizei count, GLenum usage)
   // 頂点バッファオブジェクトを作成する
   vertex = std::make_shared<GgBuffer<GgVertex>>(GL_ARRAY_BUFFER, vert, static_cast<GLsizei>(sizeof(GgVertex)), count, usage);
 
+  // 頂点の位置の境界ボックスを求める
+  bounds = GgBounds();
+  if (vert != nullptr) for (GLsizei i = 0; i < count; ++i) bounds.extend(vert[i].position.data());
+
   // 頂点の位置は index == 0 の in 変数から入力する
   glVertexAttribPointer(0, static_cast<GLint>(vert->position.size()), GL_FLOAT, GL_FALSE,
     sizeof(GgVertex), static_cast<const char*>(0) + offsetof(GgVertex, position));
@@ -5184,88 +6525,708 @@ void gg::GgTriangles::load(const GgVertex* vert, GLsizei count, GLenum usage)
 }
 
 //
-// 三角形：描画
+// 三角形：描画
+//
+void gg::GgTriangles::draw(GLint first, GLsizei count) const
+{
+  // 頂点配列オブジェクトを指定する
+  GgShape::draw(first, count);
+
+  // 図形を描画する
+  glDrawArrays(getMode(), first, count > 0 ? count : getCount() - first);
+}
+
+//
+// 三角形：インスタンス描画
+//
+void gg::GgTriangles::drawInstanced(GLsizei instances, GLint first, GLsizei count) const
+{
+  // 頂点配列オブジェクトを指定する
+  GgShape::drawInstanced(instances, first, count);
+
+  // 図形を描画する
+  const auto range{ getInstanceRange(instances) };
+  if (range[0] == 0) return;
+#if defined(__APPLE__) || defined(GL_GLES_PROTOTYPES)
+  glDrawArraysInstanced(getMode(), first, count > 0 ? count : getCount() - first, range[0]);
+#else
+  glDrawArraysInstancedBaseInstance(getMode(), first, count > 0 ? count : getCount() - first, range[0], range[1]);
+#endif
+}
+
+//
+// オブジェクト：描画
+//
+void gg::GgElements::draw(GLint first, GLsizei count) const
+{
+  // 頂点配列オブジェクトを指定する
+  GgShape::draw(first, count);
+
+  // 図形を描画する
+  glDrawElements(getMode(), count > 0 ? count : getIndexCount() - first,
+    GL_UNSIGNED_INT, static_cast<GLuint*>(0) + first);
+}
+
+//
+// オブジェクト：インスタンス描画
+//
+void gg::GgElements::drawInstanced(GLsizei instances, GLint first, GLsizei count) const
+{
+  // 頂点配列オブジェクトを指定する
+  GgShape::drawInstanced(instances, first, count);
+
+  // 図形を描画する
+  const auto range{ getInstanceRange(instances) };
+  if (range[0] == 0) return;
+#if defined(__APPLE__) || defined(GL_GLES_PROTOTYPES)
+  glDrawElementsInstanced(getMode(), count > 0 ? count : getIndexCount() - first,
+    GL_UNSIGNED_INT, static_cast<GLuint*>(0) + first, range[0]);
+#else
+  glDrawElementsInstancedBaseVertexBaseInstance(getMode(), count > 0 ? count : getIndexCount() - first,
+    GL_UNSIGNED_INT, static_cast<GLuint*>(0) + first, range[0], 0, range[1]);
+#endif
+}
+
+//
+// 境界ボックス：変換行列で変換した境界ボックスを求める
+//
+gg::GgBounds gg::GgBounds::transform(const GgMatrix& m) const
+{
+  // 空の境界ボックスは変換しない
+  if (empty()) return *this;
+
+  // 中心と各辺の長さの半分
+  const auto c{ getCenter() }, e{ getExtent() };
+
+  // 変換後の中心と各軸方向の広がり
+  GgBounds b;
+  for (int j = 0; j < 3; ++j)
+  {
+    const auto t{ m[0 + j] * c[0] + m[4 + j] * c[1] + m[8 + j] * c[2] + m[12 + j] };
+    const auto r{ std::abs(m[0 + j]) * e[0] + std::abs(m[4 + j]) * e[1] + std::abs(m[8 + j]) * e[2] };
+    b.min[j] = t - r;
+    b.max[j] = t + r;
+  }
+
+  return b;
+}
+
+//
+// 視錐台：変換行列から視錐台の平面を取り出す
+//
+gg::GgFrustum& gg::GgFrustum::load(const GgMatrix& m)
+{
+  for (int i = 0; i < 6; ++i)
+  {
+    // 左右・下上・前後の順に m の第 i / 2 行を第 4 行に加えるか第 4 行から引く
+    const auto k{ i >> 1 };
+    const auto s{ (i & 1) ? -1.0f : 1.0f };
+    auto* const p{ plane[i] };
+    for (int j = 0; j < 4; ++j) p[j] = m[j * 4 + 3] + s * m[j * 4 + k];
+
+    // 法線の長さを 1 にする
+    const auto l{ std::sqrt(p[0] * p[0] + p[1] * p[1] + p[2] * p[2]) };
+    if (l > 0.0f) for (int j = 0; j < 4; ++j) p[j] /= l;
+  }
+
+  return *this;
+}
+
+/// @cond
+
+//
+// 視錐台：v[0] + i, v[1] + i, v[2] + i からの 4 個の中心と
+//   box が false なら v[3] + i からの 4 個の半径, true なら v[3] + i, v[4] + i, v[5] + i からの
+//   4 個の各辺の長さの半分を使って視錐台と交わるかを判定し, 交わるものの位置のビットを立てて返す
+//
+static int ggFrustumMask4(const GLfloat(*plane)[4], const GLfloat* const* v, GLsizei i, bool box)
+{
+#if defined(GG_USE_SSE)
+  const auto x{ _mm_loadu_ps(v[0] + i) }, y{ _mm_loadu_ps(v[1] + i) }, z{ _mm_loadu_ps(v[2] + i) };
+  const auto absMask{ _mm_castsi128_ps(_mm_set1_epi32(0x7fffffff)) };
+  auto inside{ _mm_castsi128_ps(_mm_set1_epi32(-1)) };
+
+  for (int k = 0; k < 6; ++k)
+  {
+    const auto* const p{ plane[k] };
+    auto d{ _mm_add_ps(_mm_mul_ps(_mm_set1_ps(p[0]), x), _mm_set1_ps(p[3])) };
+    d = _mm_add_ps(d, _mm_mul_ps(_mm_set1_ps(p[1]), y));
+    d = _mm_add_ps(d, _mm_mul_ps(_mm_set1_ps(p[2]), z));
+
+    auto r{ _mm_loadu_ps(v[3] + i) };
+    if (box)
+    {
+      r = _mm_mul_ps(_mm_and_ps(_mm_set1_ps(p[0]), absMask), r);
+      r = _mm_add_ps(r, _mm_mul_ps(_mm_and_ps(_mm_set1_ps(p[1]), absMask), _mm_loadu_ps(v[4] + i)));
+      r = _mm_add_ps(r, _mm_mul_ps(_mm_and_ps(_mm_set1_ps(p[2]), absMask), _mm_loadu_ps(v[5] + i)));
+    }
+
+    inside = _mm_and_ps(inside, _mm_cmpge_ps(_mm_add_ps(d, r), _mm_setzero_ps()));
+  }
+
+  return _mm_movemask_ps(inside);
+#elif defined(GG_USE_NEON)
+  const auto x{ vld1q_f32(v[0] + i) }, y{ vld1q_f32(v[1] + i) }, z{ vld1q_f32(v[2] + i) };
+  auto inside{ vdupq_n_u32(~0u) };
+
+  for (int k = 0; k < 6; ++k)
+  {
+    const auto* const p{ plane[k] };
+    auto d{ vmlaq_n_f32(vdupq_n_f32(p[3]), x, p[0]) };
+    d = vmlaq_n_f32(d, y, p[1]);
+    d = vmlaq_n_f32(d, z, p[2]);
+
+    auto r{ vld1q_f32(v[3] + i) };
+    if (box)
+    {
+      r = vmulq_n_f32(r, std::abs(p[0]));
+      r = vmlaq_n_f32(r, vld1q_f32(v[4] + i), std::abs(p[1]));
+      r = vmlaq_n_f32(r, vld1q_f32(v[5] + i), std::abs(p[2]));
+    }
+
+    inside = vandq_u32(inside, vcgeq_f32(vaddq_f32(d, r), vdupq_n_f32(0.0f)));
+  }
+
+  return (vgetq_lane_u32(inside, 0) & 1) | (vgetq_lane_u32(inside, 1) & 2)
+    | (vgetq_lane_u32(inside, 2) & 4) | (vgetq_lane_u32(inside, 3) & 8);
+#else
+  int mask{ 0 };
+
+  for (int j = 0; j < 4; ++j)
+  {
+    const auto n{ i + j };
+    bool inside{ true };
+
+    for (int k = 0; k < 6 && inside; ++k)
+    {
+      const auto* const p{ plane[k] };
+      const auto d{ p[0] * v[0][n] + p[1] * v[1][n] + p[2] * v[2][n] + p[3] };
+      const auto r{ box
+        ? std::abs(p[0]) * v[3][n] + std::abs(p[1]) * v[4][n] + std::abs(p[2]) * v[5][n]
+        : v[3][n] };
+      inside = d + r >= 0.0f;
+    }
+
+    if (inside) mask |= 1 << j;
+  }
+
+  return mask;
+#endif
+}
+
+/// @endcond
+
+//
+// 視錐台：複数の境界球から視錐台と交わるものを選ぶ
+//
+GLsizei gg::GgFrustum::testSpheres(const GLfloat* const* sphere, GLsizei count, GLsizei* visible) const
+{
+  GLsizei n{ 0 };
+  GLsizei i{ 0 };
+
+  // 4 個ずつ判定する
+  for (; i + 4 <= count; i += 4)
+  {
+    const auto mask{ ggFrustumMask4(plane, sphere, i, false) };
+    for (int j = 0; j < 4; ++j) if (mask & (1 << j)) visible[n++] = i + j;
+  }
+
+  // 残りを判定する
+  for (; i < count; ++i)
+  {
+    if (testSphere(sphere[0][i], sphere[1][i], sphere[2][i], sphere[3][i])) visible[n++] = i;
+  }
+
+  return n;
+}
+
+//
+// 視錐台：複数の境界ボックスから視錐台と交わるものを選ぶ
+//
+GLsizei gg::GgFrustum::testBoxes(const GgBounds* box, GLsizei count, GLsizei* visible,
+  const GgMatrix* model) const
+{
+  GLsizei n{ 0 };
+
+  // 4 個の境界ボックスの中心と各辺の長さの半分を成分ごとに並べる
+  GLfloat c[6][4];
+  const GLfloat* const v[]{ c[0], c[1], c[2], c[3], c[4], c[5] };
+
+  for (GLsizei i = 0; i < count; i += 4)
+  {
+    // 空の境界ボックスと範囲外は判定から除く
+    int valid{ 0 };
+
+    for (int j = 0; j < 4; ++j)
+    {
+      GgBounds b;
+      if (i + j < count) b = model ? box[i + j].transform(model[i + j]) : box[i + j];
+
+      if (b.empty())
+      {
+        for (auto& e : c) e[j] = 0.0f;
+        continue;
+      }
+
+      const auto center{ b.getCenter() }, extent{ b.getExtent() };
+      for (int k = 0; k < 3; ++k)
+      {
+        c[k][j] = center[k];
+        c[k + 3][j] = extent[k];
+      }
+      valid |= 1 << j;
+    }
+
+    const auto mask{ ggFrustumMask4(plane, v, 0, true) & valid };
+    for (int j = 0; j < 4; ++j) if (mask & (1 << j)) visible[n++] = i + j;
+  }
+
+  return n;
+}
+
+//
+// 形状データの一覧から視錐台と交わるものを選ぶ
+//
+std::vector<GLsizei> gg::ggSelectVisible(const GgFrustum& frustum,
+  const std::vector<std::shared_ptr<GgTriangles>>& shape, const std::vector<GgMatrix>& model)
+{
+  // 形状データの境界ボックス, 形状データがなければ空にする
+  const auto count{ static_cast<GLsizei>(std::min(shape.size(), model.size())) };
+  std::vector<GgBounds> bounds(count);
+  for (GLsizei i = 0; i < count; ++i) if (shape[i]) bounds[i] = shape[i]->getBounds();
+
+  // 視錐台と交わるものの番号
+  std::vector<GLsizei> visible(count);
+  visible.resize(frustum.testBoxes(bounds.data(), count, visible.data(), model.data()));
+
+  return visible;
+}
+
+//
+// 疑似乱数：カウンタベースの疑似乱数 (Philox4x32-10) を生成する
+//
+std::array<GLuint, 4> gg::ggPhilox(GLuint counter, GLuint seed)
+{
+  std::uint32_t c[]{ counter, 0u, 0u, 0u };
+  std::uint32_t k[]{ seed, 0u };
+
+  for (int round = 0; round < 10; ++round)
+  {
+    const auto p0{ static_cast<std::uint64_t>(0xD2511F53u) * c[0] };
+    const auto p1{ static_cast<std::uint64_t>(0xCD9E8D57u) * c[2] };
+    const std::uint32_t hi0{ static_cast<std::uint32_t>(p0 >> 32) }, lo0{ static_cast<std::uint32_t>(p0) };
+    const std::uint32_t hi1{ static_cast<std::uint32_t>(p1 >> 32) }, lo1{ static_cast<std::uint32_t>(p1) };
+
+    c[0] = hi1 ^ c[1] ^ k[0];
+    c[1] = lo1;
+    c[2] = hi0 ^ c[3] ^ k[1];
+    c[3] = lo0;
+
+    k[0] += 0x9E3779B9u;
+    k[1] += 0xBB67AE85u;
+  }
+
+  return std::array<GLuint, 4>{ c[0], c[1], c[2], c[3] };
+}
+
+/// @cond
+
+//
+// 点群生成：点群の形
+//
+enum class ggPointsShape { Cube = 0, Sphere };
+
+//
+// 点群生成：32bit の乱数を [0, 1) の実数にする
+//
+static inline GLfloat ggUniform(GLuint r)
+{
+  return static_cast<GLfloat>(r >> 8) * (1.0f / 16777216.0f);
+}
+
+//
+// 点群生成：点 i の位置を求める
+//
+static gg::GgVector ggPointsPosition(ggPointsShape shape, GLsizei i, GLuint seed,
+  GLfloat size, GLfloat cx, GLfloat cy, GLfloat cz)
+{
+  const auto r{ gg::ggPhilox(static_cast<GLuint>(i), seed) };
+  const GLfloat u[]{ ggUniform(r[0]), ggUniform(r[1]), ggUniform(r[2]) };
+
+  if (shape == ggPointsShape::Cube)
+  {
+    return gg::GgVector{ (u[0] - 0.5f) * size + cx, (u[1] - 0.5f) * size + cy, (u[2] - 0.5f) * size + cz, 1.0f };
+  }
+
+  const auto d{ size * u[0] };
+  const auto t{ 6.28318530718f * u[1] };
+  const auto cp{ 2.0f * u[2] - 1.0f };
+  const auto sp{ sqrtf(1.0f - cp * cp) };
+  return gg::GgVector{ d * sp * cosf(t) + cx, d * sp * sinf(t) + cy, d * cp + cz, 1.0f };
+}
+
+#if !defined(__APPLE__)
+/// @cond
+//
+// コンピュートシェーダの実行で変更する結合の状態を保存して元に戻す
+//
+//   プログラムオブジェクトとテクスチャユニット 0 の二次元テクスチャと
+//   shader storage buffer object の結合ポイント 0 から count - 1 までの結合を保存する
+//
+class GgComputeBindingGuard
+{
+  // 保存する shader storage buffer object の結合ポイントの最大数
+  static constexpr GLuint maxCount{ 4 };
+
+  // 使用していたプログラムオブジェクト
+  GLint program;
+
+  // 選択していたテクスチャユニット
+  GLint activeTexture;
+
+  // テクスチャユニット 0 に結合していた二次元テクスチャ
+  GLint texture;
+
+  // 保存した shader storage buffer object の結合ポイントの数
+  GLuint count;
+
+  // 結合していたバッファオブジェクトとその範囲
+  std::array<GLint, maxCount> buffer;
+  std::array<GLint64, maxCount> start, size;
+
+public:
+
+  GgComputeBindingGuard(GLuint count) :
+    count{ std::min(count, maxCount) }
+  {
+    glGetIntegerv(GL_CURRENT_PROGRAM, &program);
+    glGetIntegerv(GL_ACTIVE_TEXTURE, &activeTexture);
+    glActiveTexture(GL_TEXTURE0);
+    glGetIntegerv(GL_TEXTURE_BINDING_2D, &texture);
+    for (GLuint i = 0; i < this->count; ++i)
+    {
+      glGetIntegeri_v(GL_SHADER_STORAGE_BUFFER_BINDING, i, &buffer[i]);
+      glGetInteger64i_v(GL_SHADER_STORAGE_BUFFER_START, i, &start[i]);
+      glGetInteger64i_v(GL_SHADER_STORAGE_BUFFER_SIZE, i, &size[i]);
+    }
+  }
+
+  ~GgComputeBindingGuard()
+  {
+    // 範囲を指定せずに結合していれば大きさは 0 になっている
+    for (GLuint i = 0; i < count; ++i)
+    {
+      if (buffer[i] != 0 && size[i] > 0)
+        glBindBufferRange(GL_SHADER_STORAGE_BUFFER, i, buffer[i],
+          static_cast<GLintptr>(start[i]), static_cast<GLsizeiptr>(size[i]));
+      else
+        glBindBufferBase(GL_SHADER_STORAGE_BUFFER, i, buffer[i]);
+    }
+    glActiveTexture(GL_TEXTURE0);
+    glBindTexture(GL_TEXTURE_2D, texture);
+    glActiveTexture(activeTexture);
+    glUseProgram(program);
+  }
+
+  GgComputeBindingGuard(const GgComputeBindingGuard&) = delete;
+  GgComputeBindingGuard& operator=(const GgComputeBindingGuard&) = delete;
+};
+/// @endcond
+
+//
+// 点群生成：点群を生成するコンピュートシェーダ
+//
+static const char* const ggPointsShader{ R"(#version 430
+layout(local_size_x = 256) in;
+layout(std430, binding = 0) writeonly buffer Position { vec4 position[]; };
+uniform uint count;
+uniform uint seed;
+uniform int shape;
+uniform vec4 param;
+uvec4 philox(uint counter, uint key0)
+{
+  uvec4 c = uvec4(counter, 0u, 0u, 0u);
+  uvec2 k = uvec2(key0, 0u);
+  for (int round = 0; round < 10; ++round)
+  {
+    uint hi0, lo0, hi1, lo1;
+    umulExtended(0xD2511F53u, c.x, hi0, lo0);
+    umulExtended(0xCD9E8D57u, c.z, hi1, lo1);
+    c = uvec4(hi1 ^ c.y ^ k.x, lo1, hi0 ^ c.w ^ k.y, lo0);
+    k += uvec2(0x9E3779B9u, 0xBB67AE85u);
+  }
+  return c;
+}
+void main()
+{
+  uint i = gl_GlobalInvocationID.x;
+  if (i >= count) return;
+  vec3 u = vec3(philox(i, seed).xyz >> 8u) * (1.0 / 16777216.0);
+  if (shape == 0)
+  {
+    position[i] = vec4((u - 0.5) * param.w + param.xyz, 1.0);
+  }
+  else
+  {
+    float d = param.w * u.x;
+    float t = 6.28318530718 * u.y;
+    float cp = 2.0 * u.z - 1.0;
+    float sp = sqrt(1.0 - cp * cp);
+    position[i] = vec4(d * vec3(sp * cos(t), sp * sin(t), cp) + param.xyz, 1.0);
+  }
+}
+)" };
+#endif
+
+//
+// 点群生成：点群の GgPoints オブジェクトを作成する
+//
+static std::shared_ptr<gg::GgPoints> ggCreatePoints(ggPointsShape shape, GLsizei count, GLfloat size,
+  GLfloat cx, GLfloat cy, GLfloat cz, GLuint seed, int threads, bool compute)
+{
+#if !defined(__APPLE__)
+  if (compute)
+  {
+    // コンピュートシェーダは最初に使うときに作成する
+    static const GLuint program{ gg::ggCreateComputeShader(ggPointsShader, "points generator") };
+
+    if (program != 0)
+    {
+      // データを転送せずに頂点バッファオブジェクトを確保する
+      auto points{ std::make_shared<gg::GgPoints>(nullptr, count, GL_POINTS) };
+
+      // 呼び出し側の結合を壊さないように保存しておく
+      const GgComputeBindingGuard guard{ 1 };
+
+      // 頂点バッファオブジェクトに点を生成する
+      glUseProgram(program);
+      glUniform1ui(glGetUniformLocation(program, "count"), static_cast<GLuint>(count));
+      glUniform1ui(glGetUniformLocation(program, "seed"), seed);
+      glUniform1i(glGetUniformLocation(program, "shape"), static_cast<GLint>(shape));
+      glUniform4f(glGetUniformLocation(program, "param"), cx, cy, cz, size);
+      glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 0, points->getBuffer());
+      glDispatchCompute((count + 255) / 256, 1, 1);
+      glMemoryBarrier(GL_VERTEX_ATTRIB_ARRAY_BARRIER_BIT);
+
+      return points;
+    }
+  }
+#endif
+
+  // メモリを確保する
+  std::vector<gg::GgVector> pos(count);
+
+  // 点を生成する
+  ggParallelFor(count, threads, [&](GLsizei first, GLsizei last)
+  {
+    for (GLsizei v = first; v < last; ++v) pos[v] = ggPointsPosition(shape, v, seed, size, cx, cy, cz);
+  });
+
+  // 点データの GgPoints オブジェクトを作成して返す
+  return std::make_shared<gg::GgPoints>(pos.data(), count, GL_POINTS);
+}
+
+/// @endcond
+
+//
+// 点群を立方体状に生成する
+//
+std::shared_ptr<gg::GgPoints> gg::ggPointsCube(GLsizei count, GLfloat length, GLfloat cx, GLfloat cy, GLfloat cz,
+  GLuint seed, int threads, bool compute)
+{
+  return ggCreatePoints(ggPointsShape::Cube, count, length, cx, cy, cz, seed, threads, compute);
+}
+
+//
+// 点群を球状に生成する
+//
+std::shared_ptr<gg::GgPoints> gg::ggPointsSphere(GLsizei count, GLfloat radius,
+  GLfloat cx, GLfloat cy, GLfloat cz, GLuint seed, int threads, bool compute)
+{
+  return ggCreatePoints(ggPointsShape::Sphere, count, radius, cx, cy, cz, seed, threads, compute);
+}
+
+/// @cond
+
+//
+// 形状生成：コンピュートシェーダで生成する形状
+//
+enum class ggGeneratedShape { Rectangle = 0, Ellipse, Sphere, Mesh };
+
+#if !defined(__APPLE__)
+//
+// 形状生成：頂点属性とインデックスを生成するコンピュートシェーダ
+//
+static const char* const ggShapeShader{ R"(#version 430
+layout(local_size_x = 256) in;
+struct Vertex { vec4 position; vec4 normal; };
+layout(std430, binding = 0) writeonly buffer VertexBuffer { Vertex vertex[]; };
+layout(std430, binding = 1) writeonly buffer IndexBuffer { uint index[]; };
+layout(std430, binding = 2) readonly buffer PositionBuffer { float position[]; };
+layout(std430, binding = 3) readonly buffer NormalBuffer { float normal[]; };
+uniform int shape;
+uniform uint slices;
+uniform uint stacks;
+uniform vec2 param;
+uniform bool hasNormal;
+vec3 meshPosition(uint k)
+{
+  return vec3(position[k * 3u], position[k * 3u + 1u], position[k * 3u + 2u]);
+}
+void main()
+{
+  uint id = gl_GlobalInvocationID.x;
+  uint nv = shape == 0 ? 4u : shape == 1 ? slices : (slices + 1u) * (stacks + 1u);
+  if (id < nv)
+  {
+    vec3 p, n = vec3(0.0, 0.0, 1.0);
+    if (shape == 0)
+    {
+      p = vec3(float(int(id & 1u) * 2 - 1) * param.x, float(int(id & 2u) - 1) * param.y, 0.0);
+    }
+    else if (shape == 1)
+    {
+      float t = 6.28318530717 * float(id) / float(slices);
+      p = vec3(cos(t) * param.x * 0.5, sin(t) * param.y * 0.5, 0.0);
+    }
+    else
+    {
+      uint i = id % (slices + 1u), j = id / (slices + 1u);
+      if (shape == 2)
+      {
+        float ph = 3.1415926536 * float(j) / float(stacks);
+        float th = -6.2831853072 * float(i) / float(slices);
+        n = vec3(sin(ph) * cos(th), cos(ph), sin(ph) * sin(th));
+        p = n * param.x;
+      }
+      else
+      {
+        p = meshPosition(id);
+        if (hasNormal)
+        {
+          n = vec3(normal[id * 3u], normal[id * 3u + 1u], normal[id * 3u + 2u]);
+        }
+        else
+        {
+          vec3 t = meshPosition(i < slices ? id + 1u : id) - meshPosition(i > 0u ? id - 1u : id);
+          vec3 b = meshPosition(j < stacks ? id + slices + 1u : id) - meshPosition(j > 0u ? id - slices - 1u : id);
+          n = cross(t, b);
+          float l = length(n);
+          if (l > 0.0) n /= l;
+        }
+      }
+    }
+    vertex[id] = Vertex(vec4(p, 1.0), vec4(n, 0.0));
+  }
+  if (shape >= 2 && id < slices * stacks)
+  {
+    uint k = (slices + 1u) * (id / slices) + id % slices;
+    uint f = id * 6u;
+    index[f] = k;
+    index[f + 1u] = k + slices + 2u;
+    index[f + 2u] = k + 1u;
+    index[f + 3u] = k;
+    index[f + 4u] = k + slices + 1u;
+    index[f + 5u] = k + slices + 2u;
+  }
+}
+)" };
+#endif
+
+//
+// 形状生成：コンピュートシェーダのプログラム名を取り出す, 使えなければ 0
 //
-void gg::GgTriangles::draw(GLint first, GLsizei count) const
+static GLuint ggShapeProgram()
 {
-  // 頂点配列オブジェクトを指定する
-  GgShape::draw(first, count);
-
-  // 図形を描画する
-  glDrawArrays(getMode(), first, count > 0 ? count : getCount() - first);
+#if defined(__APPLE__)
+  return 0;
+#else
+  // コンピュートシェーダは最初に使うときに作成する
+  static const GLuint program{ gg::ggCreateComputeShader(ggShapeShader, "shape generator") };
+  return program;
+#endif
 }
 
 //
-// オブジェクト：描画
+// 形状生成：コンピュートシェーダで頂点属性とインデックスを vbuf と ibuf に生成する
 //
-void gg::GgElements::draw(GLint first, GLsizei count) const
+//   pos と norm は shape が Mesh のときだけ使う
+//
+static void ggGenerateShape(ggGeneratedShape shape, GLuint slices, GLuint stacks, GLfloat a, GLfloat b,
+  GLuint vbuf, GLuint ibuf = 0, GLuint pos = 0, GLuint norm = 0)
 {
-  // 頂点配列オブジェクトを指定する
-  GgShape::draw(first, count);
-
-  // 図形を描画する
-  glDrawElements(getMode(), count > 0 ? count : getIndexCount() - first,
-    GL_UNSIGNED_INT, static_cast<GLuint*>(0) + first);
+#if !defined(__APPLE__)
+  const auto program{ ggShapeProgram() };
+
+  // 頂点数と四角形の数
+  const GLuint nv{ shape == ggGeneratedShape::Rectangle ? 4u
+    : shape == ggGeneratedShape::Ellipse ? slices : (slices + 1) * (stacks + 1) };
+  const GLuint nq{ shape >= ggGeneratedShape::Sphere ? slices * stacks : 0u };
+
+  // 呼び出し側の結合を壊さないように保存しておく
+  const GgComputeBindingGuard guard{ 4 };
+
+  glUseProgram(program);
+  glUniform1i(glGetUniformLocation(program, "shape"), static_cast<GLint>(shape));
+  glUniform1ui(glGetUniformLocation(program, "slices"), slices);
+  glUniform1ui(glGetUniformLocation(program, "stacks"), stacks);
+  glUniform2f(glGetUniformLocation(program, "param"), a, b);
+  glUniform1i(glGetUniformLocation(program, "hasNormal"), norm != 0);
+  glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 0, vbuf);
+  glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 1, ibuf);
+  glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 2, pos);
+  glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 3, norm);
+  glDispatchCompute((std::max(nv, nq) + 255) / 256, 1, 1);
+  glMemoryBarrier(GL_VERTEX_ATTRIB_ARRAY_BARRIER_BIT | GL_ELEMENT_ARRAY_BARRIER_BIT);
+#endif
 }
 
 //
-// 点群を立方体状に生成する
+// 形状生成：メッシュの頂点のインデックスを求める
 //
-std::shared_ptr<gg::GgPoints> gg::ggPointsCube(GLsizei count, GLfloat length, GLfloat cx, GLfloat cy, GLfloat cz)
+static std::vector<GLuint> ggMeshIndex(GLuint slices, GLuint stacks)
 {
-  // メモリを確保する
-  std::vector<GgVector> pos(count);
+  std::vector<GLuint> face(slices * stacks * 6);
+  auto* f{ face.data() };
 
-  // 点を生成する
-  for (GLsizei v = 0; v < count; ++v)
+  for (GLuint j = 0; j < stacks; ++j)
   {
-    const GgVector p
+    for (GLuint i = 0; i < slices; ++i)
     {
-      (static_cast<GLfloat>(rand()) / static_cast<GLfloat>(RAND_MAX) - 0.5f) * length + cx,
-      (static_cast<GLfloat>(rand()) / static_cast<GLfloat>(RAND_MAX) - 0.5f) * length + cy,
-      (static_cast<GLfloat>(rand()) / static_cast<GLfloat>(RAND_MAX) - 0.5f) * length + cz,
-      1.0f
-    };
+      // 処理対象のマス
+      const auto k{ (slices + 1) * j + i };
+
+      // マスの上半分の三角形
+      *f++ = k;
+      *f++ = k + slices + 2;
+      *f++ = k + 1;
 
-    pos.emplace_back(p);
+      // マスのお下半分の三角形
+      *f++ = k;
+      *f++ = k + slices + 1;
+      *f++ = k + slices + 2;
+    }
   }
 
-  // 点データの GgPoints オブジェクトを作成して返す
-  return std::make_shared<gg::GgPoints>(pos.data(), static_cast<GLsizei>(pos.size()), GL_POINTS);
+  return face;
 }
 
+/// @endcond
+
 //
-// 点群を球状に生成する
+// 矩形状に 2 枚の三角形を生成する
 //
-std::shared_ptr<gg::GgPoints> gg::ggPointsSphere(GLsizei count, GLfloat radius,
-  GLfloat cx, GLfloat cy, GLfloat cz)
+std::shared_ptr<gg::GgTriangles> gg::ggRectangle(GLfloat width, GLfloat height, bool compute)
 {
-  // メモリを確保する
-  std::vector<GgVector> pos(count);
-
-  // 点を生成する
-  for (GLsizei v = 0; v < count; ++v)
+  // コンピュートシェーダで生成する
+  if (compute && ggShapeProgram() != 0)
   {
-    const auto r{ radius * static_cast<GLfloat>(rand()) / static_cast<GLfloat>(RAND_MAX) };
-    const auto t{ 6.28318530718f * static_cast<GLfloat>(rand()) / (static_cast<GLfloat>(RAND_MAX) + 1.0f) };
-    const auto cp{ 2.0f * static_cast<GLfloat>(rand()) / static_cast<GLfloat>(RAND_MAX) - 1.0f };
-    const auto sp{ sqrtf(1.0f - cp * cp) };
-    const auto ct{ cosf(t) };
-    const auto st{ sinf(t) };
-    const GgVector p{ r * sp * ct + cx, r * sp * st + cy, r * cp + cz, 1.0f };
-
-    pos.emplace_back(p);
+    auto rectangle{ std::make_shared<gg::GgTriangles>(nullptr, 4, GL_TRIANGLE_STRIP) };
+    ggGenerateShape(ggGeneratedShape::Rectangle, 0, 0, width, height, rectangle->getBuffer());
+    rectangle->setBounds(GgBounds{ GgVector{ -width, -height, 0.0f, 1.0f }, GgVector{ width, height, 0.0f, 1.0f } });
+    return rectangle;
   }
 
-  // 点データの GgPoints オブジェクトを作成して返す
-  return std::make_shared<gg::GgPoints>(pos.data(), static_cast<GLsizei>(pos.size()), GL_POINTS);
-}
-
-//
-// 矩形状に 2 枚の三角形を生成する
-//
-std::shared_ptr<gg::GgTriangles> gg::ggRectangle(GLfloat width, GLfloat height)
-{
   // 頂点属性
   std::array<gg::GgVertex, 4> vert;
 
@@ -5285,13 +7246,23 @@ std::shared_ptr<gg::GgTriangles> gg::ggRectangle(GLfloat width, GLfloat height)
 //
 // 楕円状に三角形を生成する
 //
-std::shared_ptr<gg::GgTriangles> gg::ggEllipse(GLfloat width, GLfloat height, GLuint slices)
+std::shared_ptr<gg::GgTriangles> gg::ggEllipse(GLfloat width, GLfloat height, GLuint slices, bool compute)
 {
   // 楕円のスケール
   constexpr GLfloat scale{ 0.5f };
 
+  // コンピュートシェーダで生成する
+  if (compute && ggShapeProgram() != 0)
+  {
+    auto ellipse{ std::make_shared<gg::GgTriangles>(nullptr, static_cast<GLsizei>(slices), GL_TRIANGLE_FAN) };
+    ggGenerateShape(ggGeneratedShape::Ellipse, slices, 0, width, height, ellipse->getBuffer());
+    const auto w{ width * scale }, h{ height * scale };
+    ellipse->setBounds(GgBounds{ GgVector{ -w, -h, 0.0f, 1.0f }, GgVector{ w, h, 0.0f, 1.0f } });
+    return ellipse;
+  }
+
   // 作業用のメモリ
-  std::vector<gg::GgVertex> vert;
+  std::vector<gg::GgVertex> vert(slices);
 
   // 頂点位置と法線を求める
   for (GLuint v = 0; v < slices; ++v)
@@ -5300,7 +7271,7 @@ std::shared_ptr<gg::GgTriangles> gg::ggEllipse(GLfloat width, GLfloat height, GL
     const auto x{ cos(t) * width * scale };
     const auto y{ sin(t) * height * scale };
 
-    vert.emplace_back(x, y, 0.0f, 0.0f, 0.0f, 1.0f);
+    vert[v] = gg::GgVertex(x, y, 0.0f, 0.0f, 0.0f, 1.0f);
   }
 
   // GgTriangles オブジェクトを作成する
@@ -5344,10 +7315,36 @@ std::shared_ptr<gg::GgElements> gg::ggElementsObj(const std::string& name, bool
 //
 // メッシュ形状を作成する (Elements 形式)
 //
-std::shared_ptr<gg::GgElements> gg::ggElementsMesh(GLuint slices, GLuint stacks, const GLfloat(*pos)[3], const GLfloat(*norm)[3])
+std::shared_ptr<gg::GgElements> gg::ggElementsMesh(GLuint slices, GLuint stacks, const GLfloat(*pos)[3], const GLfloat(*norm)[3],
+  bool compute)
 {
+  // 頂点数
+  const auto countv{ static_cast<GLsizei>((slices + 1) * (stacks + 1)) };
+
+  // コンピュートシェーダで生成する
+  if (compute && ggShapeProgram() != 0)
+  {
+    // 頂点の位置と法線を一時的なバッファオブジェクトに転送する
+    const GgBuffer<GLfloat> p{ GL_SHADER_STORAGE_BUFFER, pos[0], static_cast<GLsizei>(sizeof(GLfloat)), countv * 3, GL_STATIC_DRAW };
+    const std::unique_ptr<const GgBuffer<GLfloat>> n{ norm
+      ? new GgBuffer<GLfloat>(GL_SHADER_STORAGE_BUFFER, norm[0], static_cast<GLsizei>(sizeof(GLfloat)), countv * 3, GL_STATIC_DRAW)
+      : nullptr };
+
+    // データを転送せずに頂点バッファオブジェクトを確保して頂点属性とインデックスを生成する
+    auto mesh{ std::make_shared<GgElements>(nullptr, countv, nullptr, static_cast<GLsizei>(slices * stacks * 6), GL_TRIANGLES) };
+    ggGenerateShape(ggGeneratedShape::Mesh, slices, stacks, 0.0f, 0.0f, mesh->getBuffer(), mesh->getIndexBuffer(),
+      p.getBuffer(), n ? n->getBuffer() : 0);
+
+    // 境界ボックスは頂点の位置から求める
+    GgBounds bounds;
+    for (GLsizei k = 0; k < countv; ++k) bounds.extend(pos[k]);
+    mesh->setBounds(bounds);
+
+    return mesh;
+  }
+
   // 頂点属性
-  std::vector<gg::GgVertex> vert((slices + 1) * (stacks + 1));
+  std::vector<gg::GgVertex> vert(countv);
 
   // 頂点の法線を求める
   for (GLuint j = 0; j <= stacks; ++j)
@@ -5404,32 +7401,12 @@ std::shared_ptr<gg::GgElements> gg::ggElementsMesh(GLuint slices, GLuint stacks,
       const gg::GgVector tpos{ pos[k][0], pos[k][1], pos[k][2], 1.0f };
 
       // 頂点属性の保存
-      vert.emplace_back(tpos, tnorm);
+      vert[k] = gg::GgVertex{ tpos, tnorm };
     }
   }
 
   // 頂点のインデックス (三角形データ)
-  std::vector<GLuint> face;
-
-  // 頂点のインデックスを求める
-  for (GLuint j = 0; j < stacks; ++j)
-  {
-    for (GLuint i = 0; i < slices; ++i)
-    {
-      // 処理対象のマス
-      const auto k{ (slices + 1) * j + i };
-
-      // マスの上半分の三角形
-      face.emplace_back(k);
-      face.emplace_back(k + slices + 2);
-      face.emplace_back(k + 1);
-
-      // マスのお下半分の三角形
-      face.emplace_back(k);
-      face.emplace_back(k + slices + 1);
-      face.emplace_back(k + slices + 2);
-    }
-  }
+  const auto face{ ggMeshIndex(slices, stacks) };
 
   // GgElements オブジェクトを作成する
   return std::make_shared<GgElements>(vert.data(), static_cast<GLsizei>(vert.size()),
@@ -5439,10 +7416,32 @@ std::shared_ptr<gg::GgElements> gg::ggElementsMesh(GLuint slices, GLuint stacks,
 //
 // 球状に三角形データを生成する (Elements 形式)
 //
-std::shared_ptr<gg::GgElements> gg::ggElementsSphere(GLfloat radius, int slices, int stacks)
+std::shared_ptr<gg::GgElements> gg::ggElementsSphere(GLfloat radius, int slices, int stacks, bool compute)
 {
+  // コンピュートシェーダで生成する
+  if (compute && ggShapeProgram() != 0)
+  {
+    const auto countv{ static_cast<GLsizei>((slices + 1) * (stacks + 1)) };
+    auto sphere{ std::make_shared<GgElements>(nullptr, countv, nullptr, static_cast<GLsizei>(slices * stacks * 6), GL_TRIANGLES) };
+    ggGenerateShape(ggGeneratedShape::Sphere, slices, stacks, radius, 0.0f, sphere->getBuffer(), sphere->getIndexBuffer());
+    sphere->setBounds(GgBounds{ GgVector{ -radius, -radius, -radius, 1.0f }, GgVector{ radius, radius, radius, 1.0f } });
+    return sphere;
+  }
+
+  // 経度方向の余弦と正弦
+  std::vector<GLfloat> ct(slices + 1), st(slices + 1);
+  for (int i = 0; i <= slices; ++i)
+  {
+    const auto s{ static_cast<GLfloat>(i) / static_cast<GLfloat>(slices) };
+    const auto th{ -2.0f * 3.1415926536f * s };
+    ct[i] = cos(th);
+    st[i] = sin(th);
+  }
+
   // 頂点の位置と法線
-  std::vector<GLfloat> p, n;
+  std::vector<GLfloat> p((slices + 1) * (stacks + 1) * 3), n(p.size());
+  auto* pp{ p.data() };
+  auto* np{ n.data() };
 
   // 頂点の位置と法線を求める
   for (int j = 0; j <= stacks; ++j)
@@ -5454,26 +7453,24 @@ std::shared_ptr<gg::GgElements> gg::ggElementsSphere(GLfloat radius, int slices,
 
     for (int i = 0; i <= slices; ++i)
     {
-      const auto s{ static_cast<GLfloat>(i) / static_cast<GLfloat>(slices) };
-      const auto th{ -2.0f * 3.1415926536f * s };
-      const auto x{ r * cos(th) };
-      const auto z{ r * sin(th) };
+      const auto x{ r * ct[i] };
+      const auto z{ r * st[i] };
 
       // 頂点の座標値
-      p.emplace_back(x * radius);
-      p.emplace_back(y * radius);
-      p.emplace_back(z * radius);
+      *pp++ = x * radius;
+      *pp++ = y * radius;
+      *pp++ = z * radius;
 
       // 頂点の法線
-      n.emplace_back(x);
-      n.emplace_back(y);
-      n.emplace_back(z);
+      *np++ = x;
+      *np++ = y;
+      *np++ = z;
     }
   }
 
   // GgElements オブジェクトを作成する
   return ggElementsMesh(slices, stacks, reinterpret_cast<GLfloat(*)[3]>(p.data()),
-    reinterpret_cast<GLfloat(*)[3]>(p.data()));
+    reinterpret_cast<GLfloat(*)[3]>(n.data()));
 }
 
 //
@@ -6013,9 +8010,68 @@ bool gg::GgSimpleShader::load(const std::string& vert, const std::string& frag,
   materialIndex = glGetUniformBlockIndex(get(), "Material");
   glUniformBlockBinding(get(), materialIndex, 1);
 
+  // 変換行列データの uniform block は使っていれば結合する
+  transformIndex = glGetUniformBlockIndex(get(), "Transform");
+  if (transformIndex >= 0) glUniformBlockBinding(get(), transformIndex, TransformBindingPoint);
+
   return true;
 }
 
+//
+// 三角形に単純な陰影付けを行うシェーダ：モデルビュー変換行列から法線変換行列を求める
+//
+const gg::GgMatrix& gg::GgSimpleShader::getNormal(const GLfloat* mv) const
+{
+  // 直前と異なるモデルビュー変換行列なら
+  if (!normalValid || !std::equal(mv, mv + 16, normalSource.begin()))
+  {
+    // 変換の種類に応じた方法で法線変換行列を求める
+    std::copy(mv, mv + 16, normalSource.begin());
+    normalMatrix.loadNormal(mv, normalSource.getKind());
+    normalValid = true;
+  }
+
+  return normalMatrix;
+}
+
+//
+// 三角形に単純な陰影付けを行うシェーダ：追加した変換行列データを一度に転送する
+//
+void gg::GgSimpleShader::TransformBuffer::flush()
+{
+  // 変換行列データの数
+  const GLsizei count{ static_cast<GLsizei>(record.size()) };
+  if (count == 0) return;
+
+  // 法線変換行列をまだ求めていない変換行列データについて
+  const Transform* previous{ nullptr };
+  for (const auto i : pending)
+  {
+    Transform& t{ record[i] };
+
+    // 直前と同じモデルビュー変換行列なら法線変換行列を使いまわす
+    if (previous && previous->mv == t.mv)
+      t.mn = previous->mn;
+    else
+      t.mn.loadNormal(t.mv, t.mv.getKind());
+    previous = &t;
+  }
+  pending.clear();
+
+  // 容量が足りなければ倍々に確保しなおす
+  if (count > getCount()) load(nullptr, std::max(count, getCount() * 2), GL_DYNAMIC_DRAW);
+
+  // ブロックの間隔に合わせて並べる
+  const GLsizeiptr stride{ getStride() };
+  staging.resize(static_cast<size_t>(stride * count));
+  for (GLsizei i = 0; i < count; ++i)
+    std::memcpy(staging.data() + stride * i, &record[i], sizeof(Transform));
+
+  // 一度に転送する
+  bind();
+  glBufferSubData(getTarget(), 0, stride * count, staging.data());
+}
+
 //
 // Wavefront OBJ 形式のデータ：コンストラクタ
 //
@@ -6041,6 +8097,29 @@ gg::GgSimpleObj::GgSimpleObj(const std::string& name, bool normalize)
 
     // 材質データを設定する
     material = std::make_shared<GgSimpleShader::MaterialBuffer>(mat.data(), static_cast<GLsizei>(mat.size()));
+
+#if !defined(__APPLE__) && !defined(GL_GLES_PROTOTYPES)
+    // 間接描画が使えれば
+    if (glMultiDrawElementsIndirect)
+    {
+      // ポリゴングループごとの描画コマンドを作成する
+      std::vector<GgDrawElementsIndirectCommand> cmd;
+      cmd.reserve(group->size());
+      for (const auto& g : *group) cmd.emplace_back(GgDrawElementsIndirectCommand{ g[1], 1, g[0], 0, g[2] });
+      command = std::make_shared<GgBuffer<GgDrawElementsIndirectCommand>>(GL_DRAW_INDIRECT_BUFFER,
+        cmd.data(), static_cast<GLsizei>(sizeof(GgDrawElementsIndirectCommand)),
+        static_cast<GLsizei>(cmd.size()), GL_STATIC_DRAW);
+      glBindBuffer(GL_DRAW_INDIRECT_BUFFER, 0);
+
+      // 全ての材質をシェーダストレージバッファに格納する
+      std::vector<StorageMaterial> sm(mat.size());
+      for (std::size_t i = 0; i < mat.size(); ++i) sm[i].material = mat[i];
+      storage = std::make_shared<GgBuffer<StorageMaterial>>(GL_SHADER_STORAGE_BUFFER,
+        sm.data(), static_cast<GLsizei>(sizeof(StorageMaterial)),
+        static_cast<GLsizei>(sm.size()), GL_STATIC_DRAW);
+      glBindBuffer(GL_SHADER_STORAGE_BUFFER, 0);
+    }
+#endif
   }
 }
 
@@ -6068,3 +8147,417 @@ void gg::GgSimpleObj::draw(GLint first, GLsizei count) const
     data->draw(g[0], g[1]);
   }
 }
+
+//
+// Wavefront OBJ 形式のデータ：図形の間接描画
+//
+void gg::GgSimpleObj::drawIndirect(GLint first, GLsizei count) const
+{
+  // 間接描画の描画コマンドがなければ通常の描画を行う
+  if (!command)
+  {
+    draw(first, count);
+    return;
+  }
+
+#if !defined(__APPLE__) && !defined(GL_GLES_PROTOTYPES)
+  // 保持しているグループの数
+  const auto ng{ static_cast<GLsizei>(group->size()) };
+
+  // 描画する最後のグループの次
+  auto last{ count <= 0 ? ng : first + count };
+  if (last > ng) last = ng;
+  if (first >= last) return;
+
+  // 頂点配列オブジェクトを指定する
+  data->GgShape::draw(first, count);
+
+  // 全ての材質を結合する
+  glBindBufferBase(GL_SHADER_STORAGE_BUFFER, MaterialStorageBindingPoint, storage->getBuffer());
+
+  // 全てのグループを一度に描画する
+  glBindBuffer(GL_DRAW_INDIRECT_BUFFER, command->getBuffer());
+  glMultiDrawElementsIndirect(data->getMode(), GL_UNSIGNED_INT,
+    static_cast<const GgDrawElementsIndirectCommand*>(0) + first, last - first, 0);
+  glBindBuffer(GL_DRAW_INDIRECT_BUFFER, 0);
+#endif
+}
+
+#if !defined(__APPLE__) && !defined(GL_GLES_PROTOTYPES)
+/// @cond
+
+//
+// 間接描画：物体の可視判定を行って描画コマンドを作るコンピュートシェーダ
+//
+static const char* const ggCullShader{ R"(#version 430
+layout(local_size_x = 64) in;
+struct Object { mat4 model; vec4 bmin; vec4 bmax; uint count; uint firstIndex; int baseVertex; uint material; };
+struct Command { uint count; uint instanceCount; uint firstIndex; int baseVertex; uint baseInstance; };
+layout(std430, binding = 0) readonly buffer Objects { Object object[]; };
+layout(std430, binding = 1) writeonly buffer Commands { Command command[]; };
+layout(std430, binding = 2) buffer Count { uint drawCount; };
+layout(std430, binding = 3) buffer Visibility { uint visibility[]; };
+uniform uint objectCount;
+uniform vec4 plane[6];
+uniform bool compact;
+uniform int phase;
+uniform mat4 mvp;
+uniform sampler2D hiz;
+bool occluded(Object o)
+{
+  mat4 m = mvp * o.model;
+  vec3 lo = vec3(1.0e30), hi = vec3(-1.0e30);
+  for (int k = 0; k < 8; ++k)
+  {
+    vec4 q = m * vec4(mix(o.bmin.xyz, o.bmax.xyz, vec3(k & 1, (k >> 1) & 1, (k >> 2) & 1)), 1.0);
+    if (q.w <= 0.0) return false;
+    lo = min(lo, q.xyz / q.w);
+    hi = max(hi, q.xyz / q.w);
+  }
+  vec2 uv0 = clamp(lo.xy * 0.5 + 0.5, 0.0, 1.0), uv1 = clamp(hi.xy * 0.5 + 0.5, 0.0, 1.0);
+  ivec2 size = textureSize(hiz, 0);
+  ivec2 p0 = clamp(ivec2(floor(uv0 * vec2(size))), ivec2(0), size - 1);
+  ivec2 p1 = clamp(ivec2(floor(uv1 * vec2(size))), ivec2(0), size - 1);
+  int levels = textureQueryLevels(hiz);
+  int level = 0;
+  while (level + 1 < levels && any(greaterThan(p1 - p0, ivec2(1))))
+  {
+    ++level;
+    ivec2 last = textureSize(hiz, level) - 1;
+    p0 = min(p0 >> 1, last);
+    p1 = min(p1 >> 1, last);
+  }
+  float d = 0.0;
+  for (int y = p0.y; y <= p1.y; ++y)
+    for (int x = p0.x; x <= p1.x; ++x) d = max(d, texelFetch(hiz, ivec2(x, y), level).r);
+  return lo.z * 0.5 + 0.5 > d;
+}
+void main()
+{
+  uint i = gl_GlobalInvocationID.x;
+  if (i >= objectCount) return;
+  Object o = object[i];
+  vec3 c = (o.model * vec4((o.bmin.xyz + o.bmax.xyz) * 0.5, 1.0)).xyz;
+  vec3 e = (o.bmax.xyz - o.bmin.xyz) * 0.5;
+  vec3 r = abs(o.model[0].xyz) * e.x + abs(o.model[1].xyz) * e.y + abs(o.model[2].xyz) * e.z;
+  bool visible = all(lessThanEqual(o.bmin.xyz, o.bmax.xyz));
+  for (int p = 0; p < 6 && visible; ++p)
+  {
+    if (dot(plane[p].xyz, c) + plane[p].w < -dot(abs(plane[p].xyz), r)) visible = false;
+  }
+  if (phase == 1)
+  {
+    visible = visible && visibility[i] != 0u;
+  }
+  else if (phase == 2)
+  {
+    bool drawn = visible && visibility[i] != 0u;
+    visible = visible && !occluded(o);
+    visibility[i] = visible ? 1u : 0u;
+    visible = visible && !drawn;
+  }
+  Command cmd = Command(o.count, visible ? 1u : 0u, o.firstIndex, o.baseVertex, i);
+  if (!compact) command[i] = cmd;
+  else if (visible) command[atomicAdd(drawCount, 1u)] = cmd;
+}
+)" };
+
+//
+// 間接描画：深度の階層を作成するコンピュートシェーダ
+//
+static const char* const ggHiZShader{ R"(#version 430
+layout(local_size_x = 8, local_size_y = 8) in;
+layout(r32f, binding = 0) readonly uniform image2D source;
+layout(r32f, binding = 1) writeonly uniform image2D destination;
+uniform sampler2D depth;
+uniform bool first;
+void main()
+{
+  ivec2 p = ivec2(gl_GlobalInvocationID.xy);
+  ivec2 size = imageSize(destination);
+  if (any(greaterThanEqual(p, size))) return;
+  if (first)
+  {
+    imageStore(destination, p, vec4(texelFetch(depth, p, 0).r));
+    return;
+  }
+  ivec2 s = p * 2;
+  float d = max(max(imageLoad(source, s).r, imageLoad(source, s + ivec2(1, 0)).r),
+    max(imageLoad(source, s + ivec2(0, 1)).r, imageLoad(source, s + ivec2(1, 1)).r));
+  ivec2 ssize = imageSize(source);
+  bool ex = (ssize.x & 1) != 0 && p.x == size.x - 1;
+  bool ey = (ssize.y & 1) != 0 && p.y == size.y - 1;
+  if (ex) d = max(d, max(imageLoad(source, s + ivec2(2, 0)).r, imageLoad(source, s + ivec2(2, 1)).r));
+  if (ey) d = max(d, max(imageLoad(source, s + ivec2(0, 2)).r, imageLoad(source, s + ivec2(1, 2)).r));
+  if (ex && ey) d = max(d, imageLoad(source, s + ivec2(2, 2)).r);
+  imageStore(destination, p, vec4(d));
+}
+)" };
+
+/// @endcond
+
+//
+// 間接描画：コンストラクタ
+//
+gg::GgIndirectScene::GgIndirectScene(const std::shared_ptr<GgElements>& mesh) :
+  mesh{ mesh },
+  dirtyFirst{ 0 },
+  dirtyLast{ 0 },
+  indirectCount{ false }
+{
+  // GPU が数えた描画コマンドの数で描画できるか調べる
+  if (glMultiDrawElementsIndirectCountARB && glGetStringi)
+  {
+    GLint n{ 0 };
+    glGetIntegerv(GL_NUM_EXTENSIONS, &n);
+    for (GLint i = 0; i < n && !indirectCount; ++i)
+    {
+      const auto* const name{ reinterpret_cast<const char*>(glGetStringi(GL_EXTENSIONS, i)) };
+      indirectCount = name && std::string(name) == "GL_ARB_indirect_parameters";
+    }
+  }
+}
+
+//
+// 間接描画：物体を追加する
+//
+GLuint gg::GgIndirectScene::add(GLuint firstIndex, GLuint count, const GgBounds& bounds,
+  const GgMatrix& model, GLint baseVertex, GLuint material)
+{
+  Object o;
+  std::copy(model.get(), model.get() + 16, o.model);
+  o.bmin = bounds.min;
+  o.bmax = bounds.max;
+  o.count = count;
+  o.firstIndex = firstIndex;
+  o.baseVertex = baseVertex;
+  o.material = material;
+
+  // 追加した物体を転送する範囲に含める
+  if (dirtyFirst >= dirtyLast) dirtyFirst = object.size();
+  object.emplace_back(o);
+  dirtyLast = object.size();
+
+  return static_cast<GLuint>(object.size() - 1);
+}
+
+//
+// 間接描画：物体のモデル変換行列を設定する
+//
+void gg::GgIndirectScene::setModel(GLuint i, const GgMatrix& model)
+{
+  std::copy(model.get(), model.get() + 16, object[i].model);
+
+  // 変更した物体を転送する範囲に含める
+  if (dirtyFirst >= dirtyLast)
+  {
+    dirtyFirst = i;
+    dirtyLast = i + 1;
+  }
+  else
+  {
+    dirtyFirst = std::min<std::size_t>(dirtyFirst, i);
+    dirtyLast = std::max<std::size_t>(dirtyLast, i + 1);
+  }
+}
+
+//
+// 間接描画：物体のデータをシェーダストレージバッファに転送する
+//
+void gg::GgIndirectScene::update()
+{
+  const auto n{ static_cast<GLsizei>(object.size()) };
+
+  // バッファが足りなければ作り直して全ての物体を転送する
+  if (!objectBuffer || objectBuffer->getCount() < n)
+  {
+    const auto capacity{ std::max<GLsizei>(n, objectBuffer ? objectBuffer->getCount() * 2 : 64) };
+    objectBuffer = std::make_shared<GgBuffer<Object>>(GL_SHADER_STORAGE_BUFFER, nullptr,
+      static_cast<GLsizei>(sizeof(Object)), capacity, GL_DYNAMIC_DRAW);
+    command = std::make_shared<GgBuffer<GgDrawElementsIndirectCommand>>(GL_DRAW_INDIRECT_BUFFER, nullptr,
+      static_cast<GLsizei>(sizeof(GgDrawElementsIndirectCommand)), capacity, GL_DYNAMIC_DRAW);
+    if (!drawCount) drawCount = std::make_shared<GgBuffer<GLuint>>(GL_SHADER_STORAGE_BUFFER, nullptr,
+      static_cast<GLsizei>(sizeof(GLuint)), 1, GL_DYNAMIC_DRAW);
+
+    // 遮蔽判定の結果は全て見えていないことにする
+    const std::vector<GLuint> hidden(capacity, 0);
+    visibility = std::make_shared<GgBuffer<GLuint>>(GL_SHADER_STORAGE_BUFFER, hidden.data(),
+      static_cast<GLsizei>(sizeof(GLuint)), capacity, GL_DYNAMIC_DRAW);
+    dirtyFirst = 0;
+    dirtyLast = object.size();
+  }
+
+  // 変更した範囲の物体を転送する
+  if (dirtyFirst < dirtyLast)
+  {
+    objectBuffer->send(object.data() + dirtyFirst, static_cast<GLint>(dirtyFirst),
+      static_cast<GLsizei>(dirtyLast - dirtyFirst));
+    dirtyFirst = dirtyLast = 0;
+  }
+}
+
+//
+// 間接描画：視錐台の外の物体を取り除いて描画コマンドを作る
+//
+void gg::GgIndirectScene::cull(const GgMatrix& mvp)
+{
+  dispatch(mvp, 0, nullptr);
+}
+
+//
+// 間接描画：前のフレームで見えていた物体の描画コマンドを作る
+//
+void gg::GgIndirectScene::cullEarly(const GgMatrix& mvp)
+{
+  dispatch(mvp, 1, nullptr);
+}
+
+//
+// 間接描画：Hi-Z で遮蔽されていない物体の描画コマンドを作る
+//
+void gg::GgIndirectScene::cullLate(const GgMatrix& mvp, const GgHiZ& hiz)
+{
+  dispatch(mvp, 2, &hiz);
+}
+
+//
+// 間接描画：可視判定のコンピュートシェーダを実行する
+//
+void gg::GgIndirectScene::dispatch(const GgMatrix& mvp, int phase, const GgHiZ* hiz)
+{
+  if (object.empty()) return;
+
+  // Hi-Z がなければ遮蔽判定は行わずに全て見えていることにする
+  if (phase == 2 && (!hiz || hiz->getTexture() == 0)) phase = 0;
+
+  // コンピュートシェーダは最初に使うときに作成する
+  static const GLuint program{ ggCreateComputeShader(ggCullShader, "indirect scene culling") };
+  if (program == 0) return;
+  static const GLint objectCountLoc{ glGetUniformLocation(program, "objectCount") };
+  static const GLint planeLoc{ glGetUniformLocation(program, "plane") };
+  static const GLint compactLoc{ glGetUniformLocation(program, "compact") };
+  static const GLint phaseLoc{ glGetUniformLocation(program, "phase") };
+  static const GLint mvpLoc{ glGetUniformLocation(program, "mvp") };
+  static const GLint hizLoc{ glGetUniformLocation(program, "hiz") };
+
+  // 物体のデータを転送する
+  update();
+
+  // 描画コマンドの数を 0 にする
+  constexpr GLuint zero{ 0 };
+  drawCount->send(&zero, 0, 1);
+
+  // 呼び出し側の結合を壊さないように保存しておく
+  const GgComputeBindingGuard guard{ 4 };
+
+  // 物体ごとに可視判定を行う
+  const GgFrustum frustum{ mvp };
+  const auto n{ static_cast<GLuint>(object.size()) };
+  glUseProgram(program);
+  glUniform1ui(objectCountLoc, n);
+  glUniform4fv(planeLoc, 6, frustum.getPlane(0));
+  glUniform1i(compactLoc, indirectCount ? GL_TRUE : GL_FALSE);
+  glUniform1i(phaseLoc, phase);
+  glUniformMatrix4fv(mvpLoc, 1, GL_FALSE, mvp.get());
+  glUniform1i(hizLoc, 0);
+  glActiveTexture(GL_TEXTURE0);
+  glBindTexture(GL_TEXTURE_2D, phase == 2 ? hiz->getTexture() : 0);
+  glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 0, objectBuffer->getBuffer());
+  glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 1, command->getBuffer());
+  glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 2, drawCount->getBuffer());
+  glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 3, visibility->getBuffer());
+  glDispatchCompute((n + 63) / 64, 1, 1);
+
+  // 描画コマンドを書き終えてから間接描画する
+  glMemoryBarrier(GL_COMMAND_BARRIER_BIT | GL_SHADER_STORAGE_BARRIER_BIT);
+}
+
+//
+// 間接描画：深度テクスチャから深度の階層を作成する
+//
+void gg::GgHiZ::build(GLuint depth, GLsizei width, GLsizei height)
+{
+  // コンピュートシェーダは最初に使うときに作成する
+  static const GLuint program{ ggCreateComputeShader(ggHiZShader, "hierarchical depth") };
+  if (program == 0 || width <= 0 || height <= 0) return;
+  static const GLint depthLoc{ glGetUniformLocation(program, "depth") };
+  static const GLint firstLoc{ glGetUniformLocation(program, "first") };
+
+  // 呼び出し側の結合を壊さないようにテクスチャを作り直す前に保存しておく
+  const GgComputeBindingGuard guard{ 0 };
+
+  // 大きさが変わったらテクスチャを作り直す
+  if (texture == 0 || width != size[0] || height != size[1])
+  {
+    glDeleteTextures(1, &texture);
+    size[0] = width;
+    size[1] = height;
+    levels = 1;
+    for (auto s{ std::max(width, height) }; s > 1; s >>= 1) ++levels;
+    glGenTextures(1, &texture);
+    glBindTexture(GL_TEXTURE_2D, texture);
+    glTexStorage2D(GL_TEXTURE_2D, levels, GL_R32F, width, height);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST_MIPMAP_NEAREST);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+  }
+
+  glUseProgram(program);
+  glUniform1i(depthLoc, 0);
+
+  // レベル 0 に深度テクスチャを複製する
+  glActiveTexture(GL_TEXTURE0);
+  glBindTexture(GL_TEXTURE_2D, depth);
+  glUniform1i(firstLoc, GL_TRUE);
+  glBindImageTexture(1, texture, 0, GL_FALSE, 0, GL_WRITE_ONLY, GL_R32F);
+  glDispatchCompute((width + 7) / 8, (height + 7) / 8, 1);
+
+  // 前のレベルの 2×2 画素の最大値で次のレベルを作る
+  glUniform1i(firstLoc, GL_FALSE);
+  for (GLint level = 1; level < levels; ++level)
+  {
+    const auto w{ std::max(width >> level, 1) }, h{ std::max(height >> level, 1) };
+    glMemoryBarrier(GL_SHADER_IMAGE_ACCESS_BARRIER_BIT);
+    glBindImageTexture(0, texture, level - 1, GL_FALSE, 0, GL_READ_ONLY, GL_R32F);
+    glBindImageTexture(1, texture, level, GL_FALSE, 0, GL_WRITE_ONLY, GL_R32F);
+    glDispatchCompute((w + 7) / 8, (h + 7) / 8, 1);
+  }
+  glBindImageTexture(0, 0, 0, GL_FALSE, 0, GL_READ_ONLY, GL_R32F);
+  glBindImageTexture(1, 0, 0, GL_FALSE, 0, GL_WRITE_ONLY, GL_R32F);
+
+  // 遮蔽判定でテクスチャとして参照する前に書き込みを完了する
+  glMemoryBarrier(GL_TEXTURE_FETCH_BARRIER_BIT);
+}
+
+//
+// 間接描画：cull() で残った物体を描画する
+//
+void gg::GgIndirectScene::draw() const
+{
+  if (!command || object.empty()) return;
+
+  // 頂点配列オブジェクトを指定する
+  mesh->GgShape::draw();
+
+  // 物体のデータを結合する
+  glBindBufferBase(GL_SHADER_STORAGE_BUFFER, SceneObjectBindingPoint, objectBuffer->getBuffer());
+
+  // 描画コマンドを描画する
+  const auto n{ static_cast<GLsizei>(object.size()) };
+  glBindBuffer(GL_DRAW_INDIRECT_BUFFER, command->getBuffer());
+  if (indirectCount)
+  {
+    // 可視判定で残った描画コマンドだけを描画する
+    glBindBuffer(GL_PARAMETER_BUFFER_ARB, drawCount->getBuffer());
+    glMultiDrawElementsIndirectCountARB(mesh->getMode(), GL_UNSIGNED_INT, nullptr, 0, n, 0);
+    glBindBuffer(GL_PARAMETER_BUFFER_ARB, 0);
+  }
+  else
+  {
+    // 取り除いた物体の描画コマンドも含めて描画する
+    glMultiDrawElementsIndirect(mesh->getMode(), GL_UNSIGNED_INT, nullptr, n, 0);
+  }
+  glBindBuffer(GL_DRAW_INDIRECT_BUFFER, 0);
+}
+#endif
@@ -35,6 +35,7 @@ CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 // 標準ライブラリ
 #include <cmath>
 #include <array>
+#include <limits>
 #include <vector>
 #include <string>
 #include <memory>
@@ -1350,6 +1351,9 @@ namespace gg
   {
     LightBindingPoint = 0,  ///< @brief 光源の uniform buffer object の結合ポイント.
     MaterialBindingPoint,   ///< @brief 材質の uniform buffer object の結合ポイント.
+    MaterialStorageBindingPoint,///< @brief GgSimpleObj::drawIndirect() の材質の shader storage buffer object の結合ポイント.
+    SceneObjectBindingPoint,    ///< @brief GgIndirectScene::draw() の物体の shader storage buffer object の結合ポイント.
+    TransformBindingPoint       ///< @brief GgSimpleShader::TransformBuffer の変換行列の uniform buffer object の結合ポイント.
   };
 
   ///
@@ -1417,6 +1421,85 @@ namespace gg
 #  define ggFBOError() gg::_ggFBOError(__FILE__, __LINE__)
 #else
 #  define ggFBOError()
+#endif
+
+#if !defined(__APPLE__) && !defined(GL_GLES_PROTOTYPES)
+  ///
+  /// OpenGL のデバッグ出力 (KHR_debug) を設定する.
+  ///
+  /// @param severity 表示するメッセージの最も低い重要度, GL_DEBUG_SEVERITY_HIGH, GL_DEBUG_SEVERITY_MEDIUM,
+  ///                 GL_DEBUG_SEVERITY_LOW, GL_DEBUG_SEVERITY_NOTIFICATION のいずれか, GL_NONE ならデバッグ出力を止める.
+  /// @param synchronous true ならエラーを起こした API の呼び出しの中でメッセージを表示する.
+  /// @return デバッグ出力が使えれば true.
+  ///
+  /// @note
+  /// DEBUG を定義してビルドしたときは ggInit() が GL_DEBUG_SEVERITY_LOW で呼び出す.
+  /// メッセージには ggDebugGroup() で指定した区間の名前を添える.
+  /// 設定はカレントのコンテキストに対して行い, デバッグ出力を使っているコンテキストでは ggError() は glGetError() を呼び出さない.
+  ///
+  extern bool ggDebugOutput(GLenum severity = GL_DEBUG_SEVERITY_LOW, bool synchronous = true);
+#endif
+
+#if defined(GL_GLES_PROTOTYPES) && !defined(GL_BUFFER)
+  // OpenGL ES 3.2 より前ではオブジェクトに名前を付けないので値は使わない
+#  define GL_BUFFER 0x82E0
+#  define GL_PROGRAM 0x82E2
+#endif
+
+  ///
+  /// OpenGL のオブジェクトにデバッグ出力で使う名前を付ける.
+  ///
+  /// @param identifier オブジェクトの種類, GL_BUFFER, GL_TEXTURE, GL_PROGRAM など.
+  /// @param name オブジェクト名.
+  /// @param label 付ける名前.
+  ///
+  /// @note
+  /// デバッグ出力を使っていなければ何もしない.
+  ///
+  extern void ggObjectLabel(GLenum identifier, GLuint name, const std::string& label);
+
+  ///
+  /// デバッグ出力の区間.
+  ///
+  /// @note
+  /// コンストラクタで glPushDebugGroup(), デストラクタで glPopDebugGroup() を呼び出す.
+  /// 通常は ggDebugGroup() マクロで使う.
+  ///
+  class GgDebugGroup
+  {
+  public:
+
+    ///
+    /// コンストラクタ.
+    ///
+    /// @param name 区間の名前.
+    ///
+    GgDebugGroup(const std::string& name);
+
+    ///
+    /// デストラクタ.
+    ///
+    ~GgDebugGroup();
+
+    GgDebugGroup(const GgDebugGroup&) = delete;
+    GgDebugGroup& operator=(const GgDebugGroup&) = delete;
+  };
+
+  ///
+  /// この行から現在のブロックの終わりまでをデバッグ出力の区間にする.
+  ///
+  /// @def ggDebugGroup(name)
+  ///
+  /// @note
+  /// グラフィックスデバッガやデバッグ出力のメッセージにこの区間の名前が表示される.
+  /// リリースビルド時には無視される.
+  ///
+#if defined(DEBUG)
+#  define GG_DEBUG_GROUP_CONCAT_(a, b) a##b
+#  define GG_DEBUG_GROUP_CONCAT(a, b) GG_DEBUG_GROUP_CONCAT_(a, b)
+#  define ggDebugGroup(name) const gg::GgDebugGroup GG_DEBUG_GROUP_CONCAT(ggDebugGroup, __LINE__){ name }
+#else
+#  define ggDebugGroup(name)
 #endif
 
   ///
@@ -2131,6 +2214,21 @@ namespace gg
 
   public:
 
+    ///
+    /// 変換行列の種類.
+    ///
+    /// @note
+    /// 逆行列や法線変換行列を求めるときに種類に応じた簡単な方法を使う.
+    /// 変換行列自体は種類を保持しないので, 作成した側が指定するか getKind() で調べる.
+    ///
+    enum Kind
+    {
+      General = 0,                      ///< 一般の変換行列.
+      Affine,                           ///< アフィン変換 (最下行が 0, 0, 0, 1).
+      Rigid,                            ///< 回転と平行移動だけの剛体変換 (loadTranslate(), loadRotate(), loadLookat() など).
+      ScaleTranslate                    ///< 拡大縮小と平行移動だけの変換 (loadTranslate(), loadScale() など).
+    };
+
     ///
     /// コンストラクタ.
     ///
@@ -2688,6 +2786,27 @@ namespace gg
       return loadInvert(m.data());
     }
 
+    ///
+    /// 変換行列の種類に応じた方法で逆行列を格納する.
+    ///
+    /// @param a GLfloat 型の 16 要素の変換行列.
+    /// @param kind a の種類.
+    /// @return 設定した a の逆行列.
+    ///
+    GgMatrix& loadInvert(const GLfloat* a, Kind kind);
+
+    ///
+    /// 変換行列の種類に応じた方法で逆行列を格納する.
+    ///
+    /// @param m GgMatrix 型の変換行列.
+    /// @param kind m の種類.
+    /// @return 設定した m の逆行列.
+    ///
+    GgMatrix& loadInvert(const GgMatrix& m, Kind kind)
+    {
+      return loadInvert(m.data(), kind);
+    }
+
     ///
     /// 法線変換行列を格納する.
     ///
@@ -2707,6 +2826,35 @@ namespace gg
       return loadNormal(m.data());
     }
 
+    ///
+    /// 変換行列の種類に応じた方法で法線変換行列を格納する.
+    ///
+    /// @param a GLfloat 型の 16 要素の変換行列.
+    /// @param kind a の種類.
+    /// @return 設定した a の法線変換行列.
+    ///
+    GgMatrix& loadNormal(const GLfloat* a, Kind kind);
+
+    ///
+    /// 変換行列の種類に応じた方法で法線変換行列を格納する.
+    ///
+    /// @param m GgMatrix 型の変換行列.
+    /// @param kind m の種類.
+    /// @return 設定した m の法線変換行列.
+    ///
+    GgMatrix& loadNormal(const GgMatrix& m, Kind kind)
+    {
+      return loadNormal(m.data(), kind);
+    }
+
+    ///
+    /// 変換行列の種類を調べる.
+    ///
+    /// @param tolerance 剛体変換とみなす回転部分の正規直交性の許容誤差.
+    /// @return この変換行列の種類.
+    ///
+    Kind getKind(GLfloat tolerance = 1.0e-5f) const;
+
     ///
     /// 平行移動変換を乗じた結果を返す.
     ///
@@ -3010,6 +3158,18 @@ namespace gg
       return t.loadInvert(*this);
     }
 
+    ///
+    /// 変換行列の種類に応じた方法で逆行列を返す.
+    ///
+    /// @param kind この変換行列の種類.
+    /// @return 逆行列.
+    ///
+    GgMatrix invert(Kind kind) const
+    {
+      GgMatrix t;
+      return t.loadInvert(*this, kind);
+    }
+
     ///
     /// 法線変換行列を返す.
     ///
@@ -3021,6 +3181,18 @@ namespace gg
       return t.loadNormal(*this);
     }
 
+    ///
+    /// 変換行列の種類に応じた方法で法線変換行列を返す.
+    ///
+    /// @param kind この変換行列の種類.
+    /// @return 法線変換行列.
+    ///
+    GgMatrix normal(Kind kind) const
+    {
+      GgMatrix t;
+      return t.loadNormal(*this, kind);
+    }
+
     ///
     /// ベクトルに対して投影変換を行う.
     ///
@@ -3104,11 +3276,16 @@ namespace gg
   ///
   /// @return 単位行列.
   ///
-  inline GgMatrix ggIdentity()
+  constexpr GgMatrix ggIdentity()
   {
-    GgMatrix t;
-    return t.loadIdentity();
-  };
+    return GgMatrix
+    {
+      1.0f, 0.0f, 0.0f, 0.0f,
+      0.0f, 1.0f, 0.0f, 0.0f,
+      0.0f, 0.0f, 1.0f, 0.0f,
+      0.0f, 0.0f, 0.0f, 1.0f
+    };
+  }
 
   ///
   /// 平行移動の変換行列を返す.
@@ -3119,10 +3296,15 @@ namespace gg
   /// @param w 移動量のスケールファクタ (= 1.0f).
   /// @return 平行移動の変換行列.
   ///
-  inline GgMatrix ggTranslate(GLfloat x, GLfloat y, GLfloat z, GLfloat w = 1.0f)
+  constexpr GgMatrix ggTranslate(GLfloat x, GLfloat y, GLfloat z, GLfloat w = 1.0f)
   {
-    GgMatrix m;
-    return m.loadTranslate(x, y, z, w);
+    return GgMatrix
+    {
+      w,    0.0f, 0.0f, 0.0f,
+      0.0f, w,    0.0f, 0.0f,
+      0.0f, 0.0f, w,    0.0f,
+      x,    y,    z,    w
+    };
   }
 
   ///
@@ -3131,10 +3313,9 @@ namespace gg
   /// @param t 移動量の GLfloat 型の 3 要素の配列変数 (x, y, z).
   /// @return 平行移動の変換行列.
   ///
-  inline GgMatrix ggTranslate(const GLfloat* t)
+  constexpr GgMatrix ggTranslate(const GLfloat* t)
   {
-    GgMatrix m;
-    return m.loadTranslate(t[0], t[1], t[2]);
+    return ggTranslate(t[0], t[1], t[2]);
   }
 
   ///
@@ -3143,10 +3324,9 @@ namespace gg
   /// @param t 移動量の GgVector 型の変数.
   /// @return 平行移動の変換行列.
   ///
-  inline GgMatrix ggTranslate(const GgVector& t)
+  constexpr GgMatrix ggTranslate(const GgVector& t)
   {
-    GgMatrix m;
-    return m.loadTranslate(t[0], t[1], t[2], t[3]);
+    return ggTranslate(t[0], t[1], t[2], t[3]);
   }
 
   ///
@@ -3158,10 +3338,15 @@ namespace gg
   /// @param w 拡大率のスケールファクタ (= 1.0f).
   /// @return 拡大縮小の変換行列.
   ///
-  inline GgMatrix ggScale(GLfloat x, GLfloat y, GLfloat z, GLfloat w = 1.0f)
+  constexpr GgMatrix ggScale(GLfloat x, GLfloat y, GLfloat z, GLfloat w = 1.0f)
   {
-    GgMatrix m;
-    return m.loadScale(x, y, z, w);
+    return GgMatrix
+    {
+      x,    0.0f, 0.0f, 0.0f,
+      0.0f, y,    0.0f, 0.0f,
+      0.0f, 0.0f, z,    0.0f,
+      0.0f, 0.0f, 0.0f, w
+    };
   }
 
   ///
@@ -3170,10 +3355,9 @@ namespace gg
   /// @param s 拡大率の GLfloat 型の 3 要素の配列変数 (x, y, z).
   /// @return 拡大縮小の変換行列.
   ///
-  inline GgMatrix ggScale(const GLfloat* s)
+  constexpr GgMatrix ggScale(const GLfloat* s)
   {
-    GgMatrix m;
-    return m.loadScale(s[0], s[1], s[2]);
+    return ggScale(s[0], s[1], s[2]);
   }
 
   ///
@@ -3182,10 +3366,9 @@ namespace gg
   /// @param s 拡大率の GgVector 型の変数.
   /// @return 拡大縮小の変換行列.
   ///
-  inline GgMatrix ggScale(const GgVector& s)
+  constexpr GgMatrix ggScale(const GgVector& s)
   {
-    GgMatrix m;
-    return m.loadScale(s[0], s[1], s[2], s[3]);
+    return ggScale(s[0], s[1], s[2], s[3]);
   }
 
   ///
@@ -3358,14 +3541,40 @@ namespace gg
   /// @param top ウィンドウの上端の位置.
   /// @param zNear 視点から前方面までの位置.
   /// @param zFar 視点から後方面までの位置.
-  /// @return 求めた直交投影変換行列.
+  /// @return 求めた直交投影変換行列, 範囲の幅が 0 なら単位行列.
   ///
-  inline GgMatrix ggOrthogonal(GLfloat left, GLfloat right,
+  constexpr GgMatrix ggOrthogonal(GLfloat left, GLfloat right,
     GLfloat bottom, GLfloat top,
     GLfloat zNear, GLfloat zFar)
   {
-    GgMatrix m;
-    return m.loadOrthogonal(left, right, bottom, top, zNear, zFar);
+    const auto dx{ right - left };
+    const auto dy{ top - bottom };
+    const auto dz{ zFar - zNear };
+
+    if (dx == 0.0f || dy == 0.0f || dz == 0.0f) return ggIdentity();
+
+    return GgMatrix
+    {
+      2.0f / dx,
+      0.0f,
+      0.0f,
+      0.0f,
+
+      0.0f,
+      2.0f / dy,
+      0.0f,
+      0.0f,
+
+      0.0f,
+      0.0f,
+      -2.0f / dz,
+      0.0f,
+
+      -(right + left) / dx,
+      -(top + bottom) / dy,
+      -(zFar + zNear) / dz,
+      1.0f
+    };
   }
 
   ///
@@ -3377,16 +3586,42 @@ namespace gg
   /// @param top ウィンドウの上端の位置.
   /// @param zNear 視点から前方面までの位置.
   /// @param zFar 視点から後方面までの位置.
-  /// @return 求めた透視投影変換行列.
+  /// @return 求めた透視投影変換行列, 範囲の幅が 0 なら単位行列.
   ///
-  inline GgMatrix ggFrustum(
+  constexpr GgMatrix ggFrustum(
     GLfloat left, GLfloat right,
     GLfloat bottom, GLfloat top,
     GLfloat zNear, GLfloat zFar
   )
   {
-    GgMatrix m;
-    return m.loadFrustum(left, right, bottom, top, zNear, zFar);
+    const auto dx{ right - left };
+    const auto dy{ top - bottom };
+    const auto dz{ zFar - zNear };
+
+    if (dx == 0.0f || dy == 0.0f || dz == 0.0f) return ggIdentity();
+
+    return GgMatrix
+    {
+      2.0f * zNear / dx,
+      0.0f,
+      0.0f,
+      0.0f,
+
+      0.0f,
+      2.0f * zNear / dy,
+      0.0f,
+      0.0f,
+
+      (right + left) / dx,
+      (top + bottom) / dy,
+      -(zFar + zNear) / dz,
+      -1.0f,
+
+      0.0f,
+      0.0f,
+      -2.0f * zFar * zNear / dz,
+      0.0f
+    };
   }
 
   ///
@@ -3413,9 +3648,15 @@ namespace gg
   /// @param m 元の変換行列.
   /// @return m の転置行列.
   ///
-  inline GgMatrix ggTranspose(const GgMatrix& m)
+  constexpr GgMatrix ggTranspose(const GgMatrix& m)
   {
-    return m.transpose();
+    return GgMatrix
+    {
+      m[ 0], m[ 4], m[ 8], m[12],
+      m[ 1], m[ 5], m[ 9], m[13],
+      m[ 2], m[ 6], m[10], m[14],
+      m[ 3], m[ 7], m[11], m[15]
+    };
   }
 
   ///
@@ -3429,6 +3670,18 @@ namespace gg
     return m.invert();
   }
 
+  ///
+  /// 変換行列の種類に応じた方法で逆行列を返す.
+  ///
+  /// @param m 元の変換行列.
+  /// @param kind m の種類.
+  /// @return m の逆行列.
+  ///
+  inline GgMatrix ggInvert(const GgMatrix& m, GgMatrix::Kind kind)
+  {
+    return m.invert(kind);
+  }
+
   ///
   /// 法線変換行列を返す.
   ///
@@ -3441,115 +3694,548 @@ namespace gg
   }
 
   ///
-  /// 四元数.
+  /// 変換行列の種類に応じた方法で法線変換行列を返す.
   ///
-  class GgQuaternion : public GgVector
+  /// @param m 元の変換行列.
+  /// @param kind m の種類.
+  /// @return m の法線変換行列.
+  ///
+  inline GgMatrix ggNormal(const GgMatrix& m, GgMatrix::Kind kind)
   {
-    // GgQuaternion 型の四元数 p と四元数 q の積を四元数 r に求める
-    void multiply(GLfloat* r, const GLfloat* p, const GLfloat* q) const;
+    return m.normal(kind);
+  }
 
-    // GgQuaternion 型の四元数 q が表す回転の変換行列を m に求める
-    void toMatrix(GLfloat* m, const GLfloat* q) const;
+  ///
+  /// 二つの変換行列の積を返す.
+  ///
+  /// @param a 左から乗じる変換行列.
+  /// @param b 右から乗じる変換行列.
+  /// @return a × b.
+  ///
+  /// @note
+  /// 定数式で使えるので, 定数の変換行列を合成するときに用いる.
+  /// 実行時には GgMatrix の演算子 * の方が速い.
+  ///
+  constexpr GgMatrix ggMultiply(const GgMatrix& a, const GgMatrix& b)
+  {
+    GgMatrix c{ 0.0f };
 
-    // 回転の変換行列 m が表す四元数を q に求める
-    void toQuaternion(GLfloat* q, const GLfloat* m) const;
+    for (int i = 0; i < 16; ++i)
+    {
+      const int j = i & 3, k = i & ~3;
 
-    // 球面線形補間 q と r を t で補間した四元数を p に求める
-    void slerp(GLfloat* p, const GLfloat* q, const GLfloat* r, GLfloat t) const;
+      c[i] = a[0 + j] * b[k + 0] + a[4 + j] * b[k + 1] + a[8 + j] * b[k + 2] + a[12 + j] * b[k + 3];
+    }
+
+    return c;
+  }
+
+  ///
+  /// 変換行列とベクトルの積を返す.
+  ///
+  /// @param m 変換行列.
+  /// @param v ベクトル.
+  /// @return m × v.
+  ///
+  /// @note
+  /// 定数式で使えるので, 定数のベクトルを変換するときに用いる.
+  ///
+  constexpr GgVector ggMultiply(const GgMatrix& m, const GgVector& v)
+  {
+    return GgVector
+    {
+      m[0] * v[0] + m[4] * v[1] + m[ 8] * v[2] + m[12] * v[3],
+      m[1] * v[0] + m[5] * v[1] + m[ 9] * v[2] + m[13] * v[3],
+      m[2] * v[0] + m[6] * v[1] + m[10] * v[2] + m[14] * v[3],
+      m[3] * v[0] + m[7] * v[1] + m[11] * v[2] + m[15] * v[3]
+    };
+  }
 
+  ///
+  /// 精度を指定した変換行列.
+  ///
+  /// @note
+  /// 原点から遠い場所を扱うときにワールド座標系の変換を倍精度で合成し,
+  /// 視点を原点に移した (カメラ相対) 後で GLfloat 型の GgMatrix に変換して GPU に送る.
+  ///
+  /// @tparam T 要素の型 (GLfloat または GLdouble).
+  ///
+  template <typename T>
+  class GgMatrixT : public std::array<T, 16>
+  {
   public:
 
     ///
     /// コンストラクタ.
     ///
-    GgQuaternion() = default;
+    GgMatrixT() = default;
 
     ///
-    /// コンストラクタ.
-    ///
-    /// @param x 四元数の x 要素.
-    /// @param y 四元数の y 要素.
-    /// @param z 四元数の z 要素.
-    /// @param w 四元数の w 要素.
+    /// 要素を指定するコンストラクタ.
     ///
-    constexpr GgQuaternion(GLfloat x, GLfloat y, GLfloat z, GLfloat w) :
-      GgVector{ x, y, z, w }
+    constexpr GgMatrixT(
+      T m00, T m01, T m02, T m03,
+      T m10, T m11, T m12, T m13,
+      T m20, T m21, T m22, T m23,
+      T m30, T m31, T m32, T m33
+    ) :
+      std::array<T, 16>{ m00, m01, m02, m03, m10, m11, m12, m13, m20, m21, m22, m23, m30, m31, m32, m33 }
     {
     }
 
     ///
-    /// コンストラクタ.
+    /// GgMatrix 型の変換行列から作成するコンストラクタ.
     ///
-    /// @param c GLfloat 型の値.
+    /// @param m GgMatrix 型の変換行列.
     ///
-    constexpr GgQuaternion(GLfloat c) :
-      GgQuaternion{ c, c, c, c }
+    GgMatrixT(const GgMatrix& m)
     {
+      for (int i = 0; i < 16; ++i) (*this)[i] = static_cast<T>(m[i]);
     }
 
     ///
-    /// コンストラクタ.
+    /// 単位行列を格納する.
     ///
-    /// @param a 四元数を格納した GLfloat 型の 4 要素の配列変数.
+    /// @return 設定した単位行列.
     ///
-    GgQuaternion(const GLfloat* a) :
-      GgQuaternion{ a[0], a[1], a[2], a[3] }
+    GgMatrixT& loadIdentity()
     {
+      return *this = GgMatrixT
+      {
+        T(1), T(0), T(0), T(0),
+        T(0), T(1), T(0), T(0),
+        T(0), T(0), T(1), T(0),
+        T(0), T(0), T(0), T(1)
+      };
     }
 
     ///
-    /// コンストラクタ.
+    /// 平行移動の変換行列を格納する.
     ///
-    /// @param v 四元数を格納した GgVector 型の変数.
+    /// @param x x 方向の移動量.
+    /// @param y y 方向の移動量.
+    /// @param z z 方向の移動量.
+    /// @return 設定した変換行列.
     ///
-    GgQuaternion(const GgVector& v) :
-      GgQuaternion{ v[0], v[1], v[2], v[3] }
+    GgMatrixT& loadTranslate(T x, T y, T z)
     {
+      return *this = GgMatrixT
+      {
+        T(1), T(0), T(0), T(0),
+        T(0), T(1), T(0), T(0),
+        T(0), T(0), T(1), T(0),
+        x,    y,    z,    T(1)
+      };
     }
 
     ///
-    /// コピーコンストラクタ.
-    ///
-    GgQuaternion(const GgQuaternion& q) = default;
-
+    /// 拡大縮小の変換行列を格納する.
     ///
-    /// ムーブコンストラクタ.
+    /// @param x x 方向の拡大率.
+    /// @param y y 方向の拡大率.
+    /// @param z z 方向の拡大率.
+    /// @return 設定した変換行列.
     ///
-    GgQuaternion(GgQuaternion&& q) = default;
+    GgMatrixT& loadScale(T x, T y, T z)
+    {
+      return *this = GgMatrixT
+      {
+        x,    T(0), T(0), T(0),
+        T(0), y,    T(0), T(0),
+        T(0), T(0), z,    T(0),
+        T(0), T(0), T(0), T(1)
+      };
+    }
 
     ///
-    /// デストラクタ.
-    ///
-    ~GgQuaternion() = default;
-
+    /// (x, y, z) を軸とする回転の変換行列を格納する.
     ///
-    /// 代入演算子.
+    /// @param x 回転軸の x 成分.
+    /// @param y 回転軸の y 成分.
+    /// @param z 回転軸の z 成分.
+    /// @param a 回転角.
+    /// @return 設定した変換行列, 回転軸の長さが 0 なら何もしない.
     ///
-    GgQuaternion& operator=(const GgQuaternion& q) = default;
+    GgMatrixT& loadRotate(T x, T y, T z, T a)
+    {
+      const auto d{ std::sqrt(x * x + y * y + z * z) };
+      if (d <= T(0)) return *this;
 
-    ///
-    /// ムーブ代入演算子.
-    ///
-    GgQuaternion& operator=(GgQuaternion&& q) = default;
+      const auto l{ x / d }, m{ y / d }, n{ z / d };
+      const auto l2{ l * l }, m2{ m * m }, n2{ n * n };
+      const auto lm{ l * m }, mn{ m * n }, nl{ n * l };
+      const auto c{ std::cos(a) }, c1{ T(1) - c };
+      const auto s{ std::sin(a) };
 
-    ///
-    /// 四元数のノルムを求める.
-    ///
-    /// @return 四元数のノルム.
-    ///
-    GLfloat norm() const
-    {
-      return ggLength4(*this);
+      return *this = GgMatrixT
+      {
+        (T(1) - l2) * c + l2, lm * c1 + n * s,      nl * c1 - m * s,      T(0),
+        lm * c1 - n * s,      (T(1) - m2) * c + m2, mn * c1 + l * s,      T(0),
+        nl * c1 + m * s,      mn * c1 - l * s,      (T(1) - n2) * c + n2, T(0),
+        T(0),                 T(0),                 T(0),                 T(1)
+      };
     }
 
     ///
-    /// 四元数に別の四元数を加算した結果を格納する.
+    /// ビュー変換行列を格納する.
     ///
-    /// @param x 加える四元数の x 要素.
-    /// @param y 加える四元数の y 要素.
-    /// @param z 加える四元数の z 要素.
-    /// @param w 加える四元数の w 要素.
-    /// @return (x, y, z, w) を加えた四元数.
+    /// @param ex 視点の位置の x 座標値.
+    /// @param ey 視点の位置の y 座標値.
+    /// @param ez 視点の位置の z 座標値.
+    /// @param tx 目標点の位置の x 座標値.
+    /// @param ty 目標点の位置の y 座標値.
+    /// @param tz 目標点の位置の z 座標値.
+    /// @param ux 上方向のベクトルの x 成分.
+    /// @param uy 上方向のベクトルの y 成分.
+    /// @param uz 上方向のベクトルの z 成分.
+    /// @return 設定したビュー変換行列, 視線と上方向が平行なら何もしない.
+    ///
+    GgMatrixT& loadLookat(
+      T ex, T ey, T ez,
+      T tx, T ty, T tz,
+      T ux, T uy, T uz
+    )
+    {
+      // z 軸 = e - t
+      const T zv[]{ ex - tx, ey - ty, ez - tz };
+
+      // x 軸 = u × z 軸
+      const T xv[]{ uy * zv[2] - uz * zv[1], uz * zv[0] - ux * zv[2], ux * zv[1] - uy * zv[0] };
+
+      // y 軸 = z 軸 × x 軸
+      const T yv[]{ zv[1] * xv[2] - zv[2] * xv[1], zv[2] * xv[0] - zv[0] * xv[2], zv[0] * xv[1] - zv[1] * xv[0] };
+
+      // 各軸の長さ
+      const auto x{ std::sqrt(xv[0] * xv[0] + xv[1] * xv[1] + xv[2] * xv[2]) };
+      const auto y{ std::sqrt(yv[0] * yv[0] + yv[1] * yv[1] + yv[2] * yv[2]) };
+      const auto z{ std::sqrt(zv[0] * zv[0] + zv[1] * zv[1] + zv[2] * zv[2]) };
+
+      // y 軸の長さをチェック
+      if (y < std::numeric_limits<T>::epsilon()) return *this;
+
+      for (int i = 0; i < 3; ++i)
+      {
+        (*this)[i * 4 + 0] = xv[i] / x;
+        (*this)[i * 4 + 1] = yv[i] / y;
+        (*this)[i * 4 + 2] = zv[i] / z;
+        (*this)[i * 4 + 3] = T(0);
+      }
+      for (int i = 0; i < 3; ++i)
+      {
+        (*this)[12 + i] = -(ex * (*this)[i] + ey * (*this)[4 + i] + ez * (*this)[8 + i]);
+      }
+      (*this)[15] = T(1);
+
+      return *this;
+    }
+
+    ///
+    /// 変換行列の積を返す.
+    ///
+    /// @param b 右から乗じる変換行列.
+    /// @return this × b.
+    ///
+    GgMatrixT operator*(const GgMatrixT& b) const
+    {
+      GgMatrixT c;
+      for (int i = 0; i < 16; ++i)
+      {
+        const int j = i & 3, k = i & ~3;
+        c[i] = (*this)[0 + j] * b[k + 0] + (*this)[4 + j] * b[k + 1]
+          + (*this)[8 + j] * b[k + 2] + (*this)[12 + j] * b[k + 3];
+      }
+      return c;
+    }
+
+    ///
+    /// GLfloat 型の GgMatrix に変換して返す.
+    ///
+    /// @return GgMatrix 型の変換行列.
+    ///
+    GgMatrix get() const
+    {
+      GgMatrix m;
+      for (int i = 0; i < 16; ++i) m[i] = static_cast<GLfloat>((*this)[i]);
+      return m;
+    }
+
+    ///
+    /// 視点を原点に移してから GLfloat 型の GgMatrix に変換して返す.
+    ///
+    /// @param ex 視点の位置の x 座標値.
+    /// @param ey 視点の位置の y 座標値.
+    /// @param ez 視点の位置の z 座標値.
+    /// @return 視点を原点とする座標系への GgMatrix 型の変換行列.
+    ///
+    /// @note
+    /// 平行移動 (-ex, -ey, -ez) を左から乗じる計算を T 型の精度で行う.
+    ///
+    GgMatrix getRelative(T ex, T ey, T ez) const
+    {
+      const T e[]{ ex, ey, ez };
+      GgMatrix m;
+      for (int k = 0; k < 16; k += 4)
+      {
+        for (int i = 0; i < 3; ++i) m[k + i] = static_cast<GLfloat>((*this)[k + i] - e[i] * (*this)[k + 3]);
+        m[k + 3] = static_cast<GLfloat>((*this)[k + 3]);
+      }
+      return m;
+    }
+  };
+
+  ///
+  /// 倍精度の変換行列.
+  ///
+  using GgMatrixd = GgMatrixT<GLdouble>;
+
+  ///
+  /// カメラ相対のビュー変換行列を返す.
+  ///
+  /// @param ex 視点の位置の x 座標値.
+  /// @param ey 視点の位置の y 座標値.
+  /// @param ez 視点の位置の z 座標値.
+  /// @param tx 目標点の位置の x 座標値.
+  /// @param ty 目標点の位置の y 座標値.
+  /// @param tz 目標点の位置の z 座標値.
+  /// @param ux 上方向のベクトルの x 成分.
+  /// @param uy 上方向のベクトルの y 成分.
+  /// @param uz 上方向のベクトルの z 成分.
+  /// @return 視点を原点に置いたときの GgMatrix 型のビュー変換行列.
+  ///
+  /// @note
+  /// 視点と目標点の差を倍精度で求めるので, 原点から遠い位置でも回転が乱れない.
+  /// モデル変換行列には GgMatrixd::getRelative() で同じ視点を原点に移したものを使う.
+  ///
+  inline GgMatrix ggLookatRelative(
+    GLdouble ex, GLdouble ey, GLdouble ez,
+    GLdouble tx, GLdouble ty, GLdouble tz,
+    GLdouble ux, GLdouble uy, GLdouble uz
+  )
+  {
+    GgMatrixd m;
+    return m.loadLookat(0.0, 0.0, 0.0, tx - ex, ty - ey, tz - ez, ux, uy, uz).get();
+  }
+
+  ///
+  /// 複数の位置ベクトルに同じ変換行列を乗じる (AoS).
+  ///
+  /// @param m 変換行列.
+  /// @param src 変換する GgVector 型の位置ベクトルの配列.
+  /// @param dst 変換結果を格納する GgVector 型の配列, src と同じでもよい.
+  /// @param count 変換する位置ベクトルの数.
+  /// @param threads 並列に処理するスレッド数, 1 以下なら並列化しない.
+  ///
+  extern void ggTransformPoints(
+    const GgMatrix& m,
+    const GgVector* src,
+    GgVector* dst,
+    GLsizei count,
+    int threads = 1
+  );
+
+  ///
+  /// 複数の位置ベクトルに同じ変換行列を乗じる (SoA).
+  ///
+  /// @param m 変換行列.
+  /// @param src 変換する位置ベクトルの x, y, z, w 成分の配列のポインタの配列.
+  /// @param dst 変換結果の x, y, z, w 成分を格納する配列のポインタの配列, src と同じでもよい.
+  /// @param count 変換する位置ベクトルの数.
+  /// @param threads 並列に処理するスレッド数, 1 以下なら並列化しない.
+  ///
+  extern void ggTransformPoints(
+    const GgMatrix& m,
+    const GLfloat* const* src,
+    GLfloat* const* dst,
+    GLsizei count,
+    int threads = 1
+  );
+
+  ///
+  /// 複数の法線ベクトルに同じ法線変換行列を乗じる (AoS).
+  ///
+  /// @param m 法線変換行列.
+  /// @param src 変換する GgVector 型の法線ベクトルの配列.
+  /// @param dst 変換結果を格納する GgVector 型の配列, src と同じでもよい.
+  /// @param count 変換する法線ベクトルの数.
+  /// @param threads 並列に処理するスレッド数, 1 以下なら並列化しない.
+  ///
+  /// @note
+  /// m の左上 3×3 の部分だけを使い, 結果の w 成分は 0 にする.
+  ///
+  extern void ggTransformNormals(
+    const GgMatrix& m,
+    const GgVector* src,
+    GgVector* dst,
+    GLsizei count,
+    int threads = 1
+  );
+
+  ///
+  /// 複数の法線ベクトルに同じ法線変換行列を乗じる (SoA).
+  ///
+  /// @param m 法線変換行列.
+  /// @param src 変換する法線ベクトルの x, y, z 成分の配列のポインタの配列.
+  /// @param dst 変換結果の x, y, z 成分を格納する配列のポインタの配列, src と同じでもよい.
+  /// @param count 変換する法線ベクトルの数.
+  /// @param threads 並列に処理するスレッド数, 1 以下なら並列化しない.
+  ///
+  /// @note
+  /// m の左上 3×3 の部分だけを使う.
+  ///
+  extern void ggTransformNormals(
+    const GgMatrix& m,
+    const GLfloat* const* src,
+    GLfloat* const* dst,
+    GLsizei count,
+    int threads = 1
+  );
+
+  ///
+  /// 複数の変換行列に同じ変換行列を左から乗じる.
+  ///
+  /// @param m 左から乗じる変換行列.
+  /// @param src 変換行列の配列.
+  /// @param dst m × src[i] を格納する配列, src と同じでもよい.
+  /// @param count 変換行列の数.
+  /// @param threads 並列に処理するスレッド数, 1 以下なら並列化しない.
+  ///
+  extern void ggMultiplyMatrices(
+    const GgMatrix& m,
+    const GgMatrix* src,
+    GgMatrix* dst,
+    GLsizei count,
+    int threads = 1
+  );
+
+  ///
+  /// 複数のモデル変換行列からモデルビュー投影変換行列を求める.
+  ///
+  /// @param mp 投影変換行列.
+  /// @param mv ビュー変換行列.
+  /// @param model モデル変換行列の配列.
+  /// @param mvp mp × mv × model[i] を格納する配列, model と同じでもよい.
+  /// @param count モデル変換行列の数.
+  /// @param threads 並列に処理するスレッド数, 1 以下なら並列化しない.
+  ///
+  extern void ggModelviewProjection(
+    const GgMatrix& mp,
+    const GgMatrix& mv,
+    const GgMatrix* model,
+    GgMatrix* mvp,
+    GLsizei count,
+    int threads = 1
+  );
+
+  ///
+  /// 四元数.
+  ///
+  class GgQuaternion : public GgVector
+  {
+    // GgQuaternion 型の四元数 p と四元数 q の積を四元数 r に求める
+    void multiply(GLfloat* r, const GLfloat* p, const GLfloat* q) const;
+
+    // GgQuaternion 型の四元数 q が表す回転の変換行列を m に求める
+    void toMatrix(GLfloat* m, const GLfloat* q) const;
+
+    // 回転の変換行列 m が表す四元数を q に求める
+    void toQuaternion(GLfloat* q, const GLfloat* m) const;
+
+    // 球面線形補間 q と r を t で補間した四元数を p に求める
+    void slerp(GLfloat* p, const GLfloat* q, const GLfloat* r, GLfloat t) const;
+
+  public:
+
+    ///
+    /// コンストラクタ.
+    ///
+    GgQuaternion() = default;
+
+    ///
+    /// コンストラクタ.
+    ///
+    /// @param x 四元数の x 要素.
+    /// @param y 四元数の y 要素.
+    /// @param z 四元数の z 要素.
+    /// @param w 四元数の w 要素.
+    ///
+    constexpr GgQuaternion(GLfloat x, GLfloat y, GLfloat z, GLfloat w) :
+      GgVector{ x, y, z, w }
+    {
+    }
+
+    ///
+    /// コンストラクタ.
+    ///
+    /// @param c GLfloat 型の値.
+    ///
+    constexpr GgQuaternion(GLfloat c) :
+      GgQuaternion{ c, c, c, c }
+    {
+    }
+
+    ///
+    /// コンストラクタ.
+    ///
+    /// @param a 四元数を格納した GLfloat 型の 4 要素の配列変数.
+    ///
+    constexpr GgQuaternion(const GLfloat* a) :
+      GgQuaternion{ a[0], a[1], a[2], a[3] }
+    {
+    }
+
+    ///
+    /// コンストラクタ.
+    ///
+    /// @param v 四元数を格納した GgVector 型の変数.
+    ///
+    GgQuaternion(const GgVector& v) :
+      GgQuaternion{ v[0], v[1], v[2], v[3] }
+    {
+    }
+
+    ///
+    /// コピーコンストラクタ.
+    ///
+    GgQuaternion(const GgQuaternion& q) = default;
+
+    ///
+    /// ムーブコンストラクタ.
+    ///
+    GgQuaternion(GgQuaternion&& q) = default;
+
+    ///
+    /// デストラクタ.
+    ///
+    ~GgQuaternion() = default;
+
+    ///
+    /// 代入演算子.
+    ///
+    GgQuaternion& operator=(const GgQuaternion& q) = default;
+
+    ///
+    /// ムーブ代入演算子.
+    ///
+    GgQuaternion& operator=(GgQuaternion&& q) = default;
+
+    ///
+    /// 四元数のノルムを求める.
+    ///
+    /// @return 四元数のノルム.
+    ///
+    GLfloat norm() const
+    {
+      return ggLength4(*this);
+    }
+
+    ///
+    /// 四元数に別の四元数を加算した結果を格納する.
+    ///
+    /// @param x 加える四元数の x 要素.
+    /// @param y 加える四元数の y 要素.
+    /// @param z 加える四元数の z 要素.
+    /// @param w 加える四元数の w 要素.
+    /// @return (x, y, z, w) を加えた四元数.
     ///
     GgQuaternion& loadAdd(GLfloat x, GLfloat y, GLfloat z, GLfloat w)
     {
@@ -4512,10 +5198,9 @@ namespace gg
   ///
   /// @return 単位四元数.
   ///
-  inline GgQuaternion ggIdentityQuaternion()
+  constexpr GgQuaternion ggIdentityQuaternion()
   {
-    GgQuaternion q;
-    return q.loadIdentity();
+    return GgQuaternion{ 0.0f, 0.0f, 0.0f, 1.0f };
   }
 
   ///
@@ -4712,9 +5397,30 @@ namespace gg
   /// @param q GgQuaternion 型の四元数.
   /// @return 四元数 q の共役四元数.
   ///
-  inline GgQuaternion ggConjugate(const GgQuaternion& q)
+  constexpr GgQuaternion ggConjugate(const GgQuaternion& q)
+  {
+    return GgQuaternion{ q[0], q[1], q[2], -q[3] };
+  }
+
+  ///
+  /// 二つの四元数の積を返す.
+  ///
+  /// @param p 左から乗じる GgQuaternion 型の四元数.
+  /// @param q 右から乗じる GgQuaternion 型の四元数.
+  /// @return p × q.
+  ///
+  /// @note
+  /// 定数式で使えるので, 定数の回転を合成するときに用いる.
+  ///
+  constexpr GgQuaternion ggMultiply(const GgQuaternion& p, const GgQuaternion& q)
   {
-    return q.conjugate();
+    return GgQuaternion
+    {
+      p[1] * q[2] - p[2] * q[1] + p[0] * q[3] + p[3] * q[0],
+      p[2] * q[0] - p[0] * q[2] + p[1] * q[3] + p[3] * q[1],
+      p[0] * q[1] - p[1] * q[0] + p[2] * q[3] + p[3] * q[2],
+      p[3] * q[3] - p[0] * q[0] - p[1] * q[1] - p[2] * q[2]
+    };
   }
 
   ///
@@ -5288,6 +5994,16 @@ namespace gg
     {
       return texture;
     }
+
+    ///
+    /// デバッグ出力で使うテクスチャの名前を付ける.
+    ///
+    /// @param label 付ける名前.
+    ///
+    void setLabel(const std::string& label) const
+    {
+      ggObjectLabel(GL_TEXTURE, texture, label);
+    }
   };
 
   ///
@@ -5629,6 +6345,16 @@ namespace gg
       return buffer;
     }
 
+    ///
+    /// デバッグ出力で使うバッファオブジェクトの名前を付ける.
+    ///
+    /// @param label 付ける名前.
+    ///
+    void setLabel(const std::string& label) const
+    {
+      ggObjectLabel(GL_BUFFER, buffer, label);
+    }
+
     ///
     /// バッファオブジェクトを結合する.
     ///
@@ -5848,6 +6574,16 @@ namespace gg
       return uniform->getBuffer();
     }
 
+    ///
+    /// デバッグ出力で使うユニフォームバッファオブジェクトの名前を付ける.
+    ///
+    /// @param label 付ける名前.
+    ///
+    void setLabel(const std::string& label) const
+    {
+      uniform->setLabel(label);
+    }
+
     ///
     /// ユニフォームバッファオブジェクトを結合する.
     ///
@@ -6091,13 +6827,735 @@ namespace gg
   };
 
   ///
-  /// 頂点配列クラス.
+  /// 成分ごとに分けて格納したベクトルの配列 (SoA).
   ///
-  class GgVertexArray
+  /// @note
+  /// x, y, z, w の各成分を別々の配列に格納する.
+  /// 各成分の配列の先頭は SIMD 命令の幅に整列し,
+  /// 要素数はその幅の倍数に切り上げて余りを 0 で埋める.
+  ///
+  class GgVectorSoA
   {
-    // 頂点配列オブジェクト
-    const GLuint vao;
-
+  public:
+
+    ///
+    /// 各成分の配列の要素数の単位.
+    ///
+    static constexpr GLsizei width{ 8 };
+
+  private:
+
+    // 各成分の配列の要素数の単位ごとに整列したブロック
+    struct alignas(32) Block
+    {
+      GLfloat v[width];
+    };
+
+    // データの数
+    GLsizei count;
+
+    // 要素数の単位に切り上げた各成分の配列の要素数
+    GLsizei padded;
+
+    // x, y, z, w の各成分の配列を順に並べた領域
+    std::vector<Block> storage;
+
+  public:
+
+    ///
+    /// コンストラクタ.
+    ///
+    /// @param count データの数.
+    ///
+    GgVectorSoA(GLsizei count = 0) :
+      count{ 0 },
+      padded{ 0 }
+    {
+      resize(count);
+    }
+
+    ///
+    /// GgVector 型の配列から作成するコンストラクタ.
+    ///
+    /// @param v GgVector 型の配列.
+    /// @param count データの数.
+    ///
+    GgVectorSoA(const GgVector* v, GLsizei count) :
+      GgVectorSoA()
+    {
+      load(v, count);
+    }
+
+    ///
+    /// GgVector 型の vector から作成するコンストラクタ.
+    ///
+    /// @param v GgVector 型の vector.
+    ///
+    GgVectorSoA(const std::vector<GgVector>& v) :
+      GgVectorSoA(v.data(), static_cast<GLsizei>(v.size()))
+    {
+    }
+
+    ///
+    /// デストラクタ.
+    ///
+    virtual ~GgVectorSoA()
+    {
+    }
+
+    ///
+    /// データの数を変更する.
+    ///
+    /// @param count 新しいデータの数.
+    ///
+    /// @note
+    /// 既存のデータは新しいデータの数の範囲で保存し, 増えた要素は 0 にする.
+    ///
+    void resize(GLsizei count);
+
+    ///
+    /// データの数を取り出す.
+    ///
+    /// @return データの数.
+    ///
+    GLsizei getCount() const
+    {
+      return count;
+    }
+
+    ///
+    /// 要素数の単位に切り上げた各成分の配列の要素数を取り出す.
+    ///
+    /// @return 各成分の配列の要素数.
+    ///
+    GLsizei getPaddedCount() const
+    {
+      return padded;
+    }
+
+    ///
+    /// 成分の配列を取り出す.
+    ///
+    /// @param i 成分の番号 (0: x, 1: y, 2: z, 3: w).
+    /// @return 成分の配列の先頭のポインタ.
+    ///
+    GLfloat* get(int i)
+    {
+      return storage.empty() ? nullptr : storage.data()->v + static_cast<size_t>(padded) * i;
+    }
+
+    ///
+    /// 成分の配列を取り出す.
+    ///
+    /// @param i 成分の番号 (0: x, 1: y, 2: z, 3: w).
+    /// @return 成分の配列の先頭のポインタ.
+    ///
+    const GLfloat* get(int i) const
+    {
+      return storage.empty() ? nullptr : storage.data()->v + static_cast<size_t>(padded) * i;
+    }
+
+    ///
+    /// 要素を GgVector 型で取り出す.
+    ///
+    /// @param i 要素の番号.
+    /// @return i 番目の要素.
+    ///
+    GgVector getVector(GLsizei i) const
+    {
+      return GgVector{ get(0)[i], get(1)[i], get(2)[i], get(3)[i] };
+    }
+
+    ///
+    /// 要素に GgVector 型の値を設定する.
+    ///
+    /// @param i 要素の番号.
+    /// @param v 設定する値.
+    ///
+    void setVector(GLsizei i, const GgVector& v)
+    {
+      for (int j = 0; j < 4; ++j) get(j)[i] = v[j];
+    }
+
+    ///
+    /// GgVector 型の配列からデータを読み込む.
+    ///
+    /// @param v GgVector 型の配列.
+    /// @param count データの数.
+    ///
+    void load(const GgVector* v, GLsizei count);
+
+    ///
+    /// GgVector 型の配列にデータを書き出す.
+    ///
+    /// @param v データの数以上の要素を持つ GgVector 型の配列.
+    ///
+    void store(GgVector* v) const;
+
+    ///
+    /// GgVector 型の vector にデータを書き出す.
+    ///
+    /// @param v 書き出し先の vector, データの数に合わせて大きさを変更する.
+    ///
+    void store(std::vector<GgVector>& v) const
+    {
+      v.resize(count);
+      store(v.data());
+    }
+
+    ///
+    /// 成分の配列のバッファオブジェクト内の位置を取り出す.
+    ///
+    /// @param i 成分の番号 (0: x, 1: y, 2: z, 3: w).
+    /// @return upload() で作成したバッファオブジェクトの先頭からのバイト数.
+    ///
+    GLintptr getOffset(int i) const
+    {
+      return static_cast<GLintptr>(sizeof(GLfloat)) * padded * i;
+    }
+
+    ///
+    /// 各成分の配列を順に並べたバッファオブジェクトを作成する.
+    ///
+    /// @param target バッファオブジェクトのターゲット.
+    /// @param usage バッファオブジェクトの使い方.
+    /// @return 作成したバッファオブジェクト.
+    ///
+    /// @note
+    /// 各成分の配列の位置は getOffset() で求める.
+    ///
+    std::shared_ptr<GgBuffer<GLfloat>> upload(
+      GLenum target = GL_ARRAY_BUFFER,
+      GLenum usage = GL_STATIC_DRAW
+    ) const
+    {
+      return std::make_shared<GgBuffer<GLfloat>>(target, get(0),
+        static_cast<GLsizei>(sizeof(GLfloat)), padded * 4, usage);
+    }
+
+    ///
+    /// upload() で作成したバッファオブジェクトにデータを転送する.
+    ///
+    /// @param buffer 転送先のバッファオブジェクト.
+    ///
+    void send(const GgBuffer<GLfloat>& buffer) const
+    {
+      buffer.send(get(0), 0, padded * 4);
+    }
+  };
+
+  ///
+  /// SoA 形式のベクトルのそれぞれの 3 要素の内積を求める.
+  ///
+  /// @param a GgVectorSoA 型の変数.
+  /// @param b a と同じ数のデータを持つ GgVectorSoA 型の変数.
+  /// @param c 結果を格納するデータの数以上の要素を持つ GLfloat 型の配列.
+  ///
+  extern void ggDot3(const GgVectorSoA& a, const GgVectorSoA& b, GLfloat* c);
+
+  ///
+  /// SoA 形式のベクトルのそれぞれの 3 要素の外積を求める.
+  ///
+  /// @param c 結果を格納する GgVectorSoA 型の変数, w 成分は 0 になる.
+  /// @param a GgVectorSoA 型の変数.
+  /// @param b a と同じ数のデータを持つ GgVectorSoA 型の変数.
+  ///
+  extern void ggCross(GgVectorSoA& c, const GgVectorSoA& a, const GgVectorSoA& b);
+
+  ///
+  /// SoA 形式のベクトルのそれぞれの 3 要素の長さを求める.
+  ///
+  /// @param a GgVectorSoA 型の変数.
+  /// @param c 結果を格納するデータの数以上の要素を持つ GLfloat 型の配列.
+  ///
+  extern void ggLength3(const GgVectorSoA& a, GLfloat* c);
+
+  ///
+  /// SoA 形式のベクトルのそれぞれの 3 要素を正規化する.
+  ///
+  /// @param a 正規化する GgVectorSoA 型の変数.
+  ///
+  /// @note
+  /// 長さが 0 の要素はそのままにする.
+  ///
+  extern void ggNormalize3(GgVectorSoA& a);
+
+  ///
+  /// SoA 形式の複数の位置ベクトルに同じ変換行列を乗じる.
+  ///
+  /// @param m 変換行列.
+  /// @param src 変換する位置ベクトル.
+  /// @param dst 変換結果を格納する GgVectorSoA 型の変数, src と同じでもよい.
+  /// @param threads 並列に処理するスレッド数, 1 以下なら並列化しない.
+  ///
+  inline void ggTransformPoints(const GgMatrix& m, const GgVectorSoA& src, GgVectorSoA& dst, int threads = 1)
+  {
+    if (&dst != &src) dst.resize(src.getCount());
+    const GLfloat* const s[]{ src.get(0), src.get(1), src.get(2), src.get(3) };
+    GLfloat* const d[]{ dst.get(0), dst.get(1), dst.get(2), dst.get(3) };
+    ggTransformPoints(m, s, d, src.getPaddedCount(), threads);
+  }
+
+  ///
+  /// SoA 形式の複数の法線ベクトルに同じ法線変換行列を乗じる.
+  ///
+  /// @param m 法線変換行列.
+  /// @param src 変換する法線ベクトル.
+  /// @param dst 変換結果を格納する GgVectorSoA 型の変数, src と同じでもよい.
+  /// @param threads 並列に処理するスレッド数, 1 以下なら並列化しない.
+  ///
+  inline void ggTransformNormals(const GgMatrix& m, const GgVectorSoA& src, GgVectorSoA& dst, int threads = 1)
+  {
+    if (&dst != &src) dst.resize(src.getCount());
+    const GLfloat* const s[]{ src.get(0), src.get(1), src.get(2) };
+    GLfloat* const d[]{ dst.get(0), dst.get(1), dst.get(2) };
+    ggTransformNormals(m, s, d, src.getPaddedCount(), threads);
+  }
+
+  ///
+  /// SoA 形式の四元数の配列のそれぞれを球面線形補間する.
+  ///
+  /// @param p 結果を格納する GgVectorSoA 型の変数, q や r と同じでもよい.
+  /// @param q 補間の始点の四元数の x, y, z, w 成分を格納した GgVectorSoA 型の変数.
+  /// @param r 補間の終点の四元数の x, y, z, w 成分を格納した q と同じ数の GgVectorSoA 型の変数.
+  /// @param t q と同じ数の補間パラメータの配列.
+  /// @param shortest true なら q と r の内積が負のとき r の符号を反転して短い方の経路で補間する.
+  ///
+  extern void ggSlerp(GgVectorSoA& p, const GgVectorSoA& q, const GgVectorSoA& r,
+    const GLfloat* t, bool shortest = true);
+
+  ///
+  /// SoA 形式の四元数の配列のそれぞれを三角関数を使わずに近似的に球面線形補間する.
+  ///
+  /// @param p 結果を格納する GgVectorSoA 型の変数, q や r と同じでもよい.
+  /// @param q 補間の始点の四元数の x, y, z, w 成分を格納した GgVectorSoA 型の変数.
+  /// @param r 補間の終点の四元数の x, y, z, w 成分を格納した q と同じ数の GgVectorSoA 型の変数.
+  /// @param t q と同じ数の補間パラメータの配列.
+  /// @param shortest true なら q と r の内積が負のとき r の符号を反転して短い方の経路で補間する.
+  ///
+  /// @note
+  /// 補間パラメータを多項式で補正して正規化線形補間するので結果は単位四元数になる.
+  /// 単位四元数の補間結果の ggSlerp() との各成分の差は 5e-4 程度以下.
+  ///
+  extern void ggSlerpApprox(GgVectorSoA& p, const GgVectorSoA& q, const GgVectorSoA& r,
+    const GLfloat* t, bool shortest = true);
+
+  ///
+  /// SoA 形式の四元数の配列のそれぞれを正規化線形補間する.
+  ///
+  /// @param p 結果を格納する GgVectorSoA 型の変数, q や r と同じでもよい.
+  /// @param q 補間の始点の四元数の x, y, z, w 成分を格納した GgVectorSoA 型の変数.
+  /// @param r 補間の終点の四元数の x, y, z, w 成分を格納した q と同じ数の GgVectorSoA 型の変数.
+  /// @param t q と同じ数の補間パラメータの配列.
+  /// @param shortest true なら q と r の内積が負のとき r の符号を反転して短い方の経路で補間する.
+  ///
+  extern void ggNlerp(GgVectorSoA& p, const GgVectorSoA& q, const GgVectorSoA& r,
+    const GLfloat* t, bool shortest = true);
+
+  ///
+  /// 軸に平行な境界ボックス.
+  ///
+  /// @note
+  /// 形状データの読み込み時に頂点の位置から求め, 視錐台カリングに使う.
+  ///
+  struct GgBounds
+  {
+    /// 最小点.
+    GgVector min;
+
+    /// 最大点.
+    GgVector max;
+
+    ///
+    /// コンストラクタ, 空の境界ボックスを作る.
+    ///
+    GgBounds() :
+      min{ std::numeric_limits<GLfloat>::max(), std::numeric_limits<GLfloat>::max(), std::numeric_limits<GLfloat>::max(), 1.0f },
+      max{ std::numeric_limits<GLfloat>::lowest(), std::numeric_limits<GLfloat>::lowest(), std::numeric_limits<GLfloat>::lowest(), 1.0f }
+    {
+    }
+
+    ///
+    /// コンストラクタ.
+    ///
+    /// @param min 最小点.
+    /// @param max 最大点.
+    ///
+    GgBounds(const GgVector& min, const GgVector& max) :
+      min{ min },
+      max{ max }
+    {
+    }
+
+    ///
+    /// 境界ボックスが空かどうか調べる.
+    ///
+    /// @return 点を一つも含んでいなければ true.
+    ///
+    bool empty() const
+    {
+      return min[0] > max[0] || min[1] > max[1] || min[2] > max[2];
+    }
+
+    ///
+    /// 点を含むように境界ボックスを広げる.
+    ///
+    /// @param p 3 要素以上の GLfloat 型の位置データのポインタ.
+    ///
+    void extend(const GLfloat* p)
+    {
+      for (int i = 0; i < 3; ++i)
+      {
+        if (p[i] < min[i]) min[i] = p[i];
+        if (p[i] > max[i]) max[i] = p[i];
+      }
+    }
+
+    ///
+    /// 中心を取り出す.
+    ///
+    /// @return 境界ボックスの中心.
+    ///
+    GgVector getCenter() const
+    {
+      return GgVector{ (min[0] + max[0]) * 0.5f, (min[1] + max[1]) * 0.5f, (min[2] + max[2]) * 0.5f, 1.0f };
+    }
+
+    ///
+    /// 各辺の長さの半分を取り出す.
+    ///
+    /// @return 境界ボックスの中心から各面までの距離.
+    ///
+    GgVector getExtent() const
+    {
+      return GgVector{ (max[0] - min[0]) * 0.5f, (max[1] - min[1]) * 0.5f, (max[2] - min[2]) * 0.5f, 0.0f };
+    }
+
+    ///
+    /// 外接球の半径を取り出す.
+    ///
+    /// @return 中心を getCenter() とする外接球の半径.
+    ///
+    GLfloat getRadius() const
+    {
+      const auto e{ getExtent() };
+      return std::sqrt(e[0] * e[0] + e[1] * e[1] + e[2] * e[2]);
+    }
+
+    ///
+    /// 変換行列で変換した境界ボックスを求める.
+    ///
+    /// @param m 変換行列.
+    /// @return 変換後の 8 頂点を含む軸に平行な境界ボックス.
+    ///
+    GgBounds transform(const GgMatrix& m) const;
+  };
+
+  ///
+  /// 視錐台.
+  ///
+  /// @note
+  /// 投影変換行列とビュー変換行列の積から 6 つの平面を取り出し, 境界ボックスや境界球の可視判定を行う.
+  /// 投影変換行列 × ビュー変換行列 × モデル変換行列から作ればモデル座標系の境界ボックスをそのまま判定できる.
+  ///
+  class GgFrustum
+  {
+    // 平面 (a, b, c, d) の係数, 法線は内側を向き長さは 1
+    GLfloat plane[6][4];
+
+  public:
+
+    ///
+    /// コンストラクタ.
+    ///
+    GgFrustum()
+    {
+    }
+
+    ///
+    /// 変換行列から視錐台を作るコンストラクタ.
+    ///
+    /// @param m 投影変換行列とビュー変換行列の積.
+    ///
+    GgFrustum(const GgMatrix& m)
+    {
+      load(m);
+    }
+
+    ///
+    /// デストラクタ.
+    ///
+    virtual ~GgFrustum()
+    {
+    }
+
+    ///
+    /// 変換行列から視錐台の平面を取り出す.
+    ///
+    /// @param m 投影変換行列とビュー変換行列の積.
+    /// @return この視錐台.
+    ///
+    GgFrustum& load(const GgMatrix& m);
+
+    ///
+    /// 視錐台の平面を取り出す.
+    ///
+    /// @param i 平面の番号 (0: 左, 1: 右, 2: 下, 3: 上, 4: 前, 5: 後).
+    /// @return 平面の方程式の係数 (a, b, c, d) を格納した配列.
+    ///
+    const GLfloat* getPlane(int i) const
+    {
+      return plane[i];
+    }
+
+    ///
+    /// 境界球が視錐台と交わるか調べる.
+    ///
+    /// @param x 境界球の中心の x 座標値.
+    /// @param y 境界球の中心の y 座標値.
+    /// @param z 境界球の中心の z 座標値.
+    /// @param r 境界球の半径.
+    /// @return 視錐台の外側になければ true.
+    ///
+    bool testSphere(GLfloat x, GLfloat y, GLfloat z, GLfloat r) const
+    {
+      for (const auto& p : plane)
+      {
+        if (p[0] * x + p[1] * y + p[2] * z + p[3] < -r) return false;
+      }
+      return true;
+    }
+
+    ///
+    /// 境界ボックスが視錐台と交わるか調べる.
+    ///
+    /// @param b 境界ボックス.
+    /// @return 視錐台の外側になければ true, 空の境界ボックスなら false.
+    ///
+    bool testBox(const GgBounds& b) const
+    {
+      if (b.empty()) return false;
+      const auto c{ b.getCenter() }, e{ b.getExtent() };
+      for (const auto& p : plane)
+      {
+        const auto d{ p[0] * c[0] + p[1] * c[1] + p[2] * c[2] + p[3] };
+        const auto r{ std::abs(p[0]) * e[0] + std::abs(p[1]) * e[1] + std::abs(p[2]) * e[2] };
+        if (d < -r) return false;
+      }
+      return true;
+    }
+
+    ///
+    /// 変換した境界ボックスが視錐台と交わるか調べる.
+    ///
+    /// @param b 境界ボックス.
+    /// @param m 境界ボックスに適用する変換行列.
+    /// @return 視錐台の外側になければ true, 空の境界ボックスなら false.
+    ///
+    bool testBox(const GgBounds& b, const GgMatrix& m) const
+    {
+      return !b.empty() && testBox(b.transform(m));
+    }
+
+    ///
+    /// 複数の境界球から視錐台と交わるものを選ぶ.
+    ///
+    /// @param sphere 境界球の中心の x, y, z 座標値と半径の 4 本の配列のポインタ.
+    /// @param count 境界球の数.
+    /// @param visible 視錐台と交わる境界球の番号を格納する count 要素以上の配列.
+    /// @return visible に格納した番号の数.
+    ///
+    /// @note
+    /// SIMD 命令が使えるときは 4 個ずつまとめて判定する.
+    ///
+    GLsizei testSpheres(const GLfloat* const* sphere, GLsizei count, GLsizei* visible) const;
+
+    ///
+    /// 複数の境界ボックスから視錐台と交わるものを選ぶ.
+    ///
+    /// @param box 境界ボックスの配列.
+    /// @param count 境界ボックスの数.
+    /// @param visible 視錐台と交わる境界ボックスの番号を格納する count 要素以上の配列.
+    /// @param model 境界ボックスごとの変換行列の配列, nullptr なら変換しない.
+    /// @return visible に格納した番号の数.
+    ///
+    /// @note
+    /// SIMD 命令が使えるときは 4 個ずつまとめて判定する.
+    ///
+    GLsizei testBoxes(const GgBounds* box, GLsizei count, GLsizei* visible,
+      const GgMatrix* model = nullptr) const;
+  };
+
+  ///
+  /// インスタンスごとの頂点属性.
+  ///
+  /// @note
+  /// GgInstanceBuffer に格納し, シェーダでは次の in 変数で受け取る.
+  /// @code
+  /// layout (location = 4) in mat4 instanceModel;     // GgInstanceModelLocation から 4 つ
+  /// layout (location = 8) in vec4 instanceColor;     // GgInstanceColorLocation
+  /// layout (location = 9) in uint instanceMaterial;  // GgInstanceMaterialLocation
+  /// @endcode
+  ///
+  struct GgInstance
+  {
+    GLfloat model[16];      ///< モデル変換行列.
+    GgVector color;         ///< 色.
+    GLuint material;        ///< 材質番号.
+    GLuint padding[3];      ///< 16 バイト境界に合わせる詰め物.
+  };
+
+  ///
+  /// インスタンスごとの頂点属性の in 変数の location.
+  ///
+  enum GgInstanceLocations
+  {
+    GgInstanceModelLocation = 4,  ///< @brief モデル変換行列 (mat4 で 4 つの location を使う).
+    GgInstanceColorLocation = 8,  ///< @brief 色.
+    GgInstanceMaterialLocation    ///< @brief 材質番号.
+  };
+
+  ///
+  /// インスタンスごとの頂点属性のリングバッファ.
+  ///
+  /// @note
+  /// capacity 個のインスタンスの領域を segments 個持ち, map() するたびに次の領域に切り替える.
+  /// GPU が読んでいる領域には書き込まないので, 毎フレーム書き換えても描画の完了を待たずにすむ.
+  /// GL_ARB_buffer_storage が使えれば永続的にマップしたバッファに直接書き込み,
+  /// 使えなければ unmap() で glBufferSubData() により転送する.
+  /// 描画するときは領域の先頭を baseInstance に指定する.
+  ///
+  class GgInstanceBuffer
+  {
+  public:
+
+    /// 領域の数.
+    static constexpr int segments{ 3 };
+
+  private:
+
+    // バッファオブジェクト
+    const GLuint buffer;
+
+    // 一つの領域に格納できるインスタンスの数
+    const GLsizei capacity;
+
+    // 永続的にマップしたバッファ, マップしていなければ nullptr
+    GgInstance* mapped;
+
+    // マップしていないときの書き込み先
+    std::vector<GgInstance> staging;
+
+    // 領域ごとの描画の完了を調べるフェンス
+    std::array<GLsync, segments> fence;
+
+    // 書き込んでいる領域の番号
+    int segment;
+
+    // 書き込んでいる領域のインスタンスの数
+    GLsizei count;
+
+  public:
+
+    ///
+    /// コンストラクタ.
+    ///
+    /// @param capacity 一フレームで描画する最大のインスタンスの数.
+    ///
+    GgInstanceBuffer(GLsizei capacity);
+
+    ///
+    /// コピーコンストラクタは使用しない.
+    ///
+    GgInstanceBuffer(const GgInstanceBuffer& buffer) = delete;
+
+    ///
+    /// デストラクタ.
+    ///
+    virtual ~GgInstanceBuffer();
+
+    ///
+    /// 代入演算子は使用しない.
+    ///
+    GgInstanceBuffer& operator=(const GgInstanceBuffer& buffer) = delete;
+
+    ///
+    /// 次の領域に切り替えて書き込み先を得る.
+    ///
+    /// @return capacity 個のインスタンスを書き込める領域の先頭のポインタ.
+    ///
+    /// @note
+    /// 前の領域にはフェンスを挿入し, 次の領域を使った描画が完了していなければ待つ.
+    /// 書き込みが終わったら unmap() を呼び出す.
+    ///
+    GgInstance* map();
+
+    ///
+    /// 書き込みを終了する.
+    ///
+    /// @param count 書き込んだインスタンスの数.
+    ///
+    void unmap(GLsizei count);
+
+    ///
+    /// 頂点配列オブジェクトにインスタンスごとの頂点属性を設定する.
+    ///
+    /// @param base 最初に読み出すインスタンスの番号.
+    ///
+    /// @note
+    /// 頂点配列オブジェクトを結合してから呼び出す.
+    ///
+    void attach(GLuint base = 0) const;
+
+    ///
+    /// バッファオブジェクト名を得る.
+    ///
+    /// @return バッファオブジェクト名.
+    ///
+    GLuint getBuffer() const
+    {
+      return buffer;
+    }
+
+    ///
+    /// 一つの領域に格納できるインスタンスの数を得る.
+    ///
+    /// @return 一フレームで描画する最大のインスタンスの数.
+    ///
+    GLsizei getCapacity() const
+    {
+      return capacity;
+    }
+
+    ///
+    /// 書き込んだインスタンスの数を得る.
+    ///
+    /// @return 最後に unmap() したインスタンスの数.
+    ///
+    GLsizei getCount() const
+    {
+      return count;
+    }
+
+    ///
+    /// 書き込んだ領域の先頭のインスタンスの番号を得る.
+    ///
+    /// @return 描画するときに baseInstance に指定する値.
+    ///
+    GLuint getBaseInstance() const
+    {
+      return static_cast<GLuint>(segment * capacity);
+    }
+  };
+
+  ///
+  /// 頂点配列クラス.
+  ///
+  class GgVertexArray
+  {
+    // 頂点配列オブジェクト
+    const GLuint vao;
+
   public:
 
     ///
@@ -6174,6 +7632,9 @@ namespace gg
     // 基本図形の種類
     GLenum mode;
 
+    // インスタンスごとの頂点属性のバッファ
+    std::shared_ptr<GgInstanceBuffer> instance;
+
   public:
 
     ///
@@ -6254,6 +7715,52 @@ namespace gg
     {
       object->bind();
     }
+
+    ///
+    /// インスタンスごとの頂点属性のバッファを設定する.
+    ///
+    /// @param instance インスタンスごとの頂点属性のバッファ.
+    ///
+    void setInstanceBuffer(const std::shared_ptr<GgInstanceBuffer>& instance)
+    {
+      this->instance = instance;
+      object->bind();
+      instance->attach();
+    }
+
+    ///
+    /// インスタンスごとの頂点属性のバッファを得る.
+    ///
+    /// @return インスタンスごとの頂点属性のバッファ, 設定していなければ空.
+    ///
+    const std::shared_ptr<GgInstanceBuffer>& getInstanceBuffer() const
+    {
+      return instance;
+    }
+
+    ///
+    /// 図形のインスタンス描画, 派生クラスでこの手続きをオーバーライドする.
+    ///
+    /// @param instances 描画するインスタンスの数, 0 ならインスタンスのバッファに書き込んだ数, それより多くは描画しない.
+    /// @param first 描画する最初のアイテム.
+    /// @param count 描画するアイテムの数, 0 なら全部のアイテムを描画する.
+    ///
+    virtual void drawInstanced(GLsizei instances = 0, GLint first = 0, GLsizei count = 0) const;
+
+  protected:
+
+    //
+    // インスタンス描画で描画するインスタンスの数と最初のインスタンスの番号を求める
+    //
+    std::array<GLuint, 2> getInstanceRange(GLsizei instances) const
+    {
+      if (!instance) return std::array<GLuint, 2>{ static_cast<GLuint>(instances > 0 ? instances : 0), 0 };
+
+      // 書き込んだ数を超えると次のセグメントやバッファの外を読むので書き込んだ数までにする
+      const auto written{ instance->getCount() };
+      return std::array<GLuint, 2>{ static_cast<GLuint>(instances > 0 && instances < written ? instances : written),
+        instance->getBaseInstance() };
+    }
   };
 
   ///
@@ -6369,6 +7876,15 @@ namespace gg
     /// @param count 描画する点の数, 0 なら全部の点を描く.
     ///
     virtual void draw(GLint first = 0, GLsizei count = 0) const;
+
+    ///
+    /// 点のインスタンス描画.
+    ///
+    /// @param instances 描画するインスタンスの数, 0 ならインスタンスのバッファに書き込んだ数.
+    /// @param first 描画を開始する最初の点の番号.
+    /// @param count 描画する点の数, 0 なら全部の点を描く.
+    ///
+    virtual void drawInstanced(GLsizei instances = 0, GLint first = 0, GLsizei count = 0) const;
   };
 
   ///
@@ -6441,6 +7957,9 @@ namespace gg
     // 頂点属性
     std::shared_ptr<GgBuffer<GgVertex>> vertex;
 
+    // 頂点の位置の境界ボックス
+    GgBounds bounds;
+
   public:
 
     ///
@@ -6520,6 +8039,41 @@ namespace gg
     ///
     void load(const GgVertex* vert, GLsizei count, GLenum usage = GL_STATIC_DRAW);
 
+    ///
+    /// 境界ボックスを取り出す.
+    ///
+    /// @return load() で転送した頂点の位置から求めたモデル座標系の境界ボックス.
+    ///
+    /// @note
+    /// send() で頂点属性を更新しても境界ボックスは更新しないので, 必要なら setBounds() で設定する.
+    ///
+    const GgBounds& getBounds() const
+    {
+      return bounds;
+    }
+
+    ///
+    /// 境界ボックスを設定する.
+    ///
+    /// @param bounds モデル座標系の境界ボックス.
+    ///
+    void setBounds(const GgBounds& bounds)
+    {
+      this->bounds = bounds;
+    }
+
+    ///
+    /// 視錐台と交わるか調べる.
+    ///
+    /// @param frustum 視錐台.
+    /// @param model この図形のモデル変換行列.
+    /// @return 視錐台の外側になければ true.
+    ///
+    bool isVisible(const GgFrustum& frustum, const GgMatrix& model) const
+    {
+      return frustum.testBox(bounds, model);
+    }
+
     ///
     /// 三角形の描画.
     ///
@@ -6527,6 +8081,15 @@ namespace gg
     /// @param count 描画する三角形数, 0 なら全部の三角形を描く.
     ///
     virtual void draw(GLint first = 0, GLsizei count = 0) const;
+
+    ///
+    /// 三角形のインスタンス描画.
+    ///
+    /// @param instances 描画するインスタンスの数, 0 ならインスタンスのバッファに書き込んだ数.
+    /// @param first 描画を開始する最初の三角形番号.
+    /// @param count 描画する三角形数, 0 なら全部の三角形を描く.
+    ///
+    virtual void drawInstanced(GLsizei instances = 0, GLint first = 0, GLsizei count = 0) const;
   };
 
   ///
@@ -6653,8 +8216,40 @@ namespace gg
     /// @param count 描画する三角形数, 0 なら全部の三角形を描く.
     ///
     virtual void draw(GLint first = 0, GLsizei count = 0) const;
+
+    ///
+    /// インデックスを使った三角形のインスタンス描画.
+    ///
+    /// @param instances 描画するインスタンスの数, 0 ならインスタンスのバッファに書き込んだ数.
+    /// @param first 描画を開始する最初の三角形番号.
+    /// @param count 描画する三角形数, 0 なら全部の三角形を描く.
+    ///
+    virtual void drawInstanced(GLsizei instances = 0, GLint first = 0, GLsizei count = 0) const;
   };
 
+  ///
+  /// 形状データの一覧から視錐台と交わるものを選ぶ.
+  ///
+  /// @param frustum 視錐台.
+  /// @param shape 形状データの一覧.
+  /// @param model 形状データごとのモデル変換行列の一覧, shape と同じ数.
+  /// @return 視錐台と交わる形状データの shape 中の番号の一覧.
+  ///
+  extern std::vector<GLsizei> ggSelectVisible(const GgFrustum& frustum,
+    const std::vector<std::shared_ptr<GgTriangles>>& shape, const std::vector<GgMatrix>& model);
+
+  ///
+  /// カウンタベースの疑似乱数 (Philox4x32-10) を生成する.
+  ///
+  /// @param counter カウンタ, 同じ seed なら counter ごとに独立した乱数が得られる.
+  /// @param seed 乱数の種.
+  /// @return 4 個の 32bit の乱数.
+  ///
+  /// @note
+  /// 状態を持たないので, 同じ counter と seed からはスレッド数や実行環境に依らず同じ値が得られる.
+  ///
+  extern std::array<GLuint, 4> ggPhilox(GLuint counter, GLuint seed = 0);
+
   ///
   /// 点群を立方体状に生成する.
   ///
@@ -6663,14 +8258,23 @@ namespace gg
   /// @param cx 点群の中心の x 座標.
   /// @param cy 点群の中心の y 座標.
   /// @param cz 点群の中心の z 座標.
+  /// @param seed 乱数の種.
+  /// @param threads CPU で生成するときに使うスレッド数.
+  /// @param compute true ならコンピュートシェーダで頂点バッファオブジェクトに直接生成する.
   /// @return GgPoints 型の ポインタ.
   ///
+  /// @note
+  /// 点 i の位置は ggPhilox(i, seed) から求めるので, スレッド数に依らず同じ点群が得られる.
+  ///
   extern std::shared_ptr<GgPoints> ggPointsCube(
     GLsizei countv,
     GLfloat length = 1.0f,
     GLfloat cx = 0.0f,
     GLfloat cy = 0.0f,
-    GLfloat cz = 0.0f
+    GLfloat cz = 0.0f,
+    GLuint seed = 0,
+    int threads = 1,
+    bool compute = false
   );
 
   ///
@@ -6681,14 +8285,23 @@ namespace gg
   /// @param cx 点群の中心の x 座標.
   /// @param cy 点群の中心の y 座標.
   /// @param cz 点群の中心の z 座標.
+  /// @param seed 乱数の種.
+  /// @param threads CPU で生成するときに使うスレッド数.
+  /// @param compute true ならコンピュートシェーダで頂点バッファオブジェクトに直接生成する.
   /// @return GgPoints 型のポインタ.
   ///
+  /// @note
+  /// 点 i の位置は ggPhilox(i, seed) から求めるので, スレッド数に依らず同じ点群が得られる.
+  ///
   extern std::shared_ptr<GgPoints> ggPointsSphere(
     GLsizei countv,
     GLfloat radius = 0.5f,
     GLfloat cx = 0.0f,
     GLfloat cy = 0.0f,
-    GLfloat cz = 0.0f
+    GLfloat cz = 0.0f,
+    GLuint seed = 0,
+    int threads = 1,
+    bool compute = false
   );
 
   ///
@@ -6696,11 +8309,13 @@ namespace gg
   ///
   /// @param width 矩形の横幅.
   /// @param height 矩形の高さ.
+  /// @param compute true ならコンピュートシェーダで頂点バッファオブジェクトに直接生成する.
   /// @return GgTriangles 型のポインタ.
   ///
   extern std::shared_ptr<GgTriangles> ggRectangle(
     GLfloat width = 1.0f,
-    GLfloat height = 1.0f
+    GLfloat height = 1.0f,
+    bool compute = false
   );
 
   ///
@@ -6709,12 +8324,14 @@ namespace gg
   /// @param width 楕円の横幅.
   /// @param height 楕円の高さ.
   /// @param slices 楕円の分割数.
+  /// @param compute true ならコンピュートシェーダで頂点バッファオブジェクトに直接生成する.
   /// @return GgTriangles 型のポインタ.
   ///
   extern std::shared_ptr<GgTriangles> ggEllipse(
     GLfloat width = 1.0f,
     GLfloat height = 1.0f,
-    GLuint slices = 16
+    GLuint slices = 16,
+    bool compute = false
   );
 
   ///
@@ -6756,16 +8373,20 @@ namespace gg
   /// @param stacks メッシュの縦方向の分割数.
   /// @param pos メッシュの頂点の位置.
   /// @param norm メッシュの頂点の法線, nullptr なら頂点の位置から算出する.
+  /// @param compute true なら法線の算出とインデックスの生成をコンピュートシェーダで行う.
   /// @return GgElements 型のポインタ.
   ///
   /// @note
   /// メッシュ状に GgElements 形式の三角形データを生成する.
+  /// compute が true のときは pos と norm を一時的なバッファオブジェクトに転送し,
+  /// 頂点属性とインデックスはコンピュートシェーダで頂点バッファオブジェクトに直接格納する.
   ///
   extern std::shared_ptr<GgElements> ggElementsMesh(
     GLuint slices,
     GLuint stacks,
     const GLfloat(*pos)[3],
-    const GLfloat(*norm)[3] = nullptr
+    const GLfloat(*norm)[3] = nullptr,
+    bool compute = false
   );
 
   /// 球状に三角形データを生成する (Elements 形式).
@@ -6773,6 +8394,7 @@ namespace gg
   /// @param radius 球の半径.
   /// @param slices 球の経度方向の分割数.
   /// @param stacks 球の緯度方向の分割数.
+  /// @param compute true ならコンピュートシェーダで頂点バッファオブジェクトに直接生成する.
   /// @return GgElements 型のポインタ.
   ///
   /// @note
@@ -6781,7 +8403,8 @@ namespace gg
   extern std::shared_ptr<GgElements> ggElementsSphere(
     GLfloat radius = 1.0f,
     int slices = 16,
-    int stacks = 8
+    int stacks = 8,
+    bool compute = false
   );
 
   ///
@@ -6888,6 +8511,16 @@ namespace gg
     {
       return program;
     }
+
+    ///
+    /// デバッグ出力で使うプログラムオブジェクトの名前を付ける.
+    ///
+    /// @param label 付ける名前.
+    ///
+    void setLabel(const std::string& label) const
+    {
+      ggObjectLabel(GL_PROGRAM, program, label);
+    }
   };
 
   ///
@@ -7143,6 +8776,16 @@ namespace gg
     {
       return shader->get();
     }
+
+    ///
+    /// デバッグ出力で使うプログラムオブジェクトの名前を付ける.
+    ///
+    /// @param label 付ける名前.
+    ///
+    void setLabel(const std::string& label) const
+    {
+      shader->setLabel(label);
+    }
   };
 
   ///
@@ -7160,6 +8803,26 @@ namespace gg
     // モデルビュー変換の法線変換行列の uniform 変数の場所
     GLint mnLoc;
 
+    // 変換行列データの uniform block のインデックス
+    GLint transformIndex;
+
+    // 直前に法線変換行列を求めたモデルビュー変換行列
+    mutable GgMatrix normalSource;
+
+    // 直前に求めた法線変換行列
+    mutable GgMatrix normalMatrix;
+
+    // normalMatrix が normalSource から求めたものなら true
+    mutable bool normalValid{ false };
+
+    ///
+    /// モデルビュー変換行列から法線変換行列を求める.
+    ///
+    /// @param mv GLfloat 型の 16 要素の配列変数に格納されたモデルビュー変換行列.
+    /// @return mv の法線変換行列, mv が直前と同じなら前回の結果を使いまわす.
+    ///
+    const GgMatrix& getNormal(const GLfloat* mv) const;
+
   public:
 
     ///
@@ -7169,7 +8832,8 @@ namespace gg
       GgPointShader(),
       materialIndex{ -1 },
       lightIndex{ -1 },
-      mnLoc{ -1 }
+      mnLoc{ -1 },
+      transformIndex{ -1 }
     {
     }
 
@@ -7216,7 +8880,11 @@ namespace gg
       GgPointShader(o),
       materialIndex{ o.materialIndex },
       lightIndex{ o.lightIndex },
-      mnLoc{ o.mnLoc }
+      mnLoc{ o.mnLoc },
+      transformIndex{ o.transformIndex },
+      normalSource{ o.normalSource },
+      normalMatrix{ o.normalMatrix },
+      normalValid{ o.normalValid }
     {
     }
 
@@ -7238,6 +8906,10 @@ namespace gg
         materialIndex = o.materialIndex;
         lightIndex = o.lightIndex;
         mnLoc = o.mnLoc;
+        transformIndex = o.transformIndex;
+        normalSource = o.normalSource;
+        normalMatrix = o.normalMatrix;
+        normalValid = o.normalValid;
       }
 
       return *this;
@@ -7305,10 +8977,11 @@ namespace gg
     /// モデルビュー変換行列とそれから求めた法線変換行列を設定する.
     ///
     /// @param mv GLfloat 型の 16 要素の配列変数に格納されたモデルビュー変換行列.
+    /// @note 法線変換行列は mv が直前と異なるときだけ変換の種類に応じた方法で求める.
     ///
     virtual void loadModelviewMatrix(const GLfloat* mv) const
     {
-      loadModelviewMatrix(mv, GgMatrix(mv).normal().get());
+      loadModelviewMatrix(mv, getNormal(mv).get());
     }
 
     ///
@@ -7354,7 +9027,7 @@ namespace gg
     ///
     virtual void loadMatrix(const GLfloat* mp, const GLfloat* mv) const
     {
-      loadMatrix(mp, mv, GgMatrix(mv).normal());
+      loadMatrix(mp, mv, getNormal(mv).get());
     }
 
     ///
@@ -7365,7 +9038,7 @@ namespace gg
     ///
     virtual void loadMatrix(const GgMatrix& mp, const GgMatrix& mv) const
     {
-      loadMatrix(mp, mv, mv.normal());
+      loadMatrix(mp.get(), mv.get());
     }
 
     ///
@@ -7889,6 +9562,123 @@ namespace gg
       }
     };
 
+    ///
+    /// 三角形に単純な陰影付けを行うシェーダが参照する変換行列データ.
+    ///
+    struct Transform
+    {
+      GgMatrix mp;        ///< 投影変換行列.
+      GgMatrix mv;        ///< モデルビュー変換行列.
+      GgMatrix mn;        ///< モデルビュー変換行列の法線変換行列.
+    };
+
+    ///
+    /// 描画ごとの変換行列データをまとめて転送するユニフォームバッファオブジェクト.
+    ///
+    /// フレーム内の描画ごとに push() で変換行列を追加し, flush() で一度に転送したあと,
+    /// それぞれの描画の直前に push() が返した番号を select() で選択する.
+    /// シェーダでは uniform block Transform に mat4 の mp, mv, mn をこの順に宣言する.
+    ///
+    class TransformBuffer
+      : public GgUniformBuffer<Transform>
+    {
+      // 転送前の変換行列データ
+      std::vector<Transform> record;
+
+      // 法線変換行列をまだ求めていない変換行列データの番号
+      std::vector<GLsizei> pending;
+
+      // ブロックの間隔に合わせて並べた転送用のデータ
+      std::vector<char> staging;
+
+    public:
+
+      ///
+      /// デフォルトコンストラクタ.
+      ///
+      /// @param count 最初に確保する GgSimpleShader::Transform 型の変換行列データの数.
+      ///
+      TransformBuffer(GLsizei count = 1) :
+        GgUniformBuffer<Transform>(static_cast<const Transform*>(nullptr), count, GL_DYNAMIC_DRAW)
+      {
+        record.reserve(count);
+      }
+
+      ///
+      /// デストラクタ.
+      ///
+      virtual ~TransformBuffer()
+      {
+      }
+
+      ///
+      /// 変換行列データを追加する.
+      ///
+      /// @param mp GgMatrix 型の投影変換行列.
+      /// @param mv GgMatrix 型のモデルビュー変換行列.
+      /// @return 追加した変換行列データの番号.
+      /// @note 法線変換行列は flush() のときに求める.
+      ///
+      GLint push(const GgMatrix& mp, const GgMatrix& mv)
+      {
+        pending.emplace_back(static_cast<GLsizei>(record.size()));
+        record.emplace_back(Transform{ mp, mv, GgMatrix{} });
+        return static_cast<GLint>(record.size()) - 1;
+      }
+
+      ///
+      /// 変換行列データを追加する.
+      ///
+      /// @param mp GgMatrix 型の投影変換行列.
+      /// @param mv GgMatrix 型のモデルビュー変換行列.
+      /// @param mn GgMatrix 型のモデルビュー変換行列の法線変換行列.
+      /// @return 追加した変換行列データの番号.
+      ///
+      GLint push(const GgMatrix& mp, const GgMatrix& mv, const GgMatrix& mn)
+      {
+        record.emplace_back(Transform{ mp, mv, mn });
+        return static_cast<GLint>(record.size()) - 1;
+      }
+
+      ///
+      /// 追加した変換行列データの数を取り出す.
+      ///
+      /// @return push() で追加した変換行列データの数.
+      ///
+      GLsizei size() const
+      {
+        return static_cast<GLsizei>(record.size());
+      }
+
+      ///
+      /// 追加した変換行列データを一度に転送する.
+      ///
+      /// まだ求めていない法線変換行列を求め, 容量が足りなければバッファオブジェクトを確保しなおす.
+      ///
+      void flush();
+
+      ///
+      /// 追加した変換行列データを捨てる.
+      ///
+      void reset()
+      {
+        record.clear();
+        pending.clear();
+      }
+
+      ///
+      /// 変換行列データを選択する.
+      ///
+      /// @param i push() が返した変換行列データの番号.
+      ///
+      void select(GLint i = 0) const
+      {
+        // バッファオブジェクトの i 番目のブロックの位置
+        const GLintptr offset{ static_cast<GLintptr>(getStride()) * i };
+        glBindBufferRange(getTarget(), TransformBindingPoint, getBuffer(), offset, sizeof(Transform));
+      }
+    };
+
     ///
     /// シェーダプログラムの使用を開始する.
     ///
@@ -7934,7 +9724,7 @@ namespace gg
     ///
     void use(const GLfloat* mp, const GLfloat* mv) const
     {
-      use(mp, mv, GgMatrix(mv).normal().get());
+      use(mp, mv, getNormal(mv).get());
     }
 
     ///
@@ -7945,7 +9735,7 @@ namespace gg
     ///
     void use(const GgMatrix& mp, const GgMatrix& mv) const
     {
-      use(mp, mv, mv.normal());
+      use(mp.get(), mv.get());
     }
 
     ///
@@ -8033,7 +9823,7 @@ namespace gg
       GLint i = 0
     ) const
     {
-      use(mp, mv, GgMatrix(mv).normal().get(), light, i);
+      use(mp, mv, getNormal(mv).get(), light, i);
     }
 
     ///
@@ -8051,7 +9841,7 @@ namespace gg
       GLint i = 0
     ) const
     {
-      use(mp, mv, mv.normal(), light, i);
+      use(mp.get(), mv.get(), &light, i);
     }
 
     ///
@@ -8122,6 +9912,18 @@ namespace gg
     bool normalize = false
   );
 
+  ///
+  /// glMultiDrawElementsIndirect() の描画コマンド.
+  ///
+  struct GgDrawElementsIndirectCommand
+  {
+    GLuint count;           ///< 描画する頂点インデックスの数.
+    GLuint instanceCount;   ///< 描画するインスタンスの数.
+    GLuint firstIndex;      ///< 最初の頂点インデックスの位置.
+    GLint baseVertex;       ///< 頂点インデックスに加える値.
+    GLuint baseInstance;    ///< インスタンス番号に加える値.
+  };
+
   ///
   /// Wavefront OBJ 形式のファイル (Arrays 形式).
   ///
@@ -8136,6 +9938,20 @@ namespace gg
     // この図形の形状データ
     std::shared_ptr<GgElements> data;
 
+    // シェーダストレージバッファに格納する材質 (std430 の構造体の配列の間隔に合わせる)
+    struct StorageMaterial
+    {
+      GgSimpleShader::Material material;
+      GLfloat padding[3];
+    };
+    static_assert(sizeof(StorageMaterial) == 64, "StorageMaterial must match the std430 layout.");
+
+    // ポリゴングループごとの描画コマンドの間接描画バッファ
+    std::shared_ptr<GgBuffer<GgDrawElementsIndirectCommand>> command;
+
+    // 全ての材質を格納したシェーダストレージバッファ
+    std::shared_ptr<GgBuffer<StorageMaterial>> storage;
+
   public:
 
     ///
@@ -8189,5 +10005,315 @@ namespace gg
     /// @param count 描画するパーツの数, 0 なら全部のパーツを描く.
     ///
     virtual void draw(GLint first = 0, GLsizei count = 0) const;
+
+    ///
+    /// Wavefront OBJ 形式のデータを一回の間接描画で描画する手続き.
+    ///
+    /// @param first 描画する最初のパーツ番号.
+    /// @param count 描画するパーツの数, 0 なら全部のパーツを描く.
+    ///
+    /// @note
+    /// 読み込み時に作成した描画コマンドで全てのパーツを glMultiDrawElementsIndirect() で描画する.
+    /// 材質はパーツごとに結合し直さず, 全ての材質を格納したシェーダストレージバッファを
+    /// MaterialStorageBindingPoint に結合し, 描画コマンドの baseInstance に材質番号を入れる.
+    /// シェーダでは材質を次のように参照する (gl_BaseInstance は GLSL 4.60 か ARB_shader_draw_parameters).
+    /// @code
+    /// struct Material { vec4 kamb, kdiff, kspec; float kshi; };
+    /// layout (std430, binding = 2) readonly buffer Materials { Material material[]; };
+    /// ... material[gl_BaseInstance] ...
+    /// @endcode
+    /// 間接描画が使えない環境では draw() で描画する.
+    ///
+    virtual void drawIndirect(GLint first = 0, GLsizei count = 0) const;
+  };
+
+#if !defined(__APPLE__) && !defined(GL_GLES_PROTOTYPES)
+  ///
+  /// 深度バッファの階層 (Hi-Z).
+  ///
+  /// @note
+  /// 深度テクスチャをミップマップの各レベルに 2×2 画素の最大値で縮小したテクスチャで,
+  /// 画面上の矩形の奥行きの最大値を数回のテクスチャの参照で求められる. GgIndirectScene::cullLate() で使う.
+  ///
+  class GgHiZ
+  {
+    // 深度の階層を格納するテクスチャ
+    GLuint texture;
+
+    // レベル 0 の横と縦の画素数
+    GLsizei size[2];
+
+    // ミップマップのレベル数
+    GLsizei levels;
+
+  public:
+
+    ///
+    /// コンストラクタ.
+    ///
+    GgHiZ() :
+      texture{ 0 },
+      size{ 0, 0 },
+      levels{ 0 }
+    {
+    }
+
+    ///
+    /// コピーコンストラクタは使用しない.
+    ///
+    GgHiZ(const GgHiZ& hiz) = delete;
+
+    ///
+    /// デストラクタ.
+    ///
+    virtual ~GgHiZ()
+    {
+      glDeleteTextures(1, &texture);
+    }
+
+    ///
+    /// 代入演算子は使用しない.
+    ///
+    GgHiZ& operator=(const GgHiZ& hiz) = delete;
+
+    ///
+    /// 深度テクスチャから深度の階層を作成する.
+    ///
+    /// @param depth 深度テクスチャのテクスチャ名, 比較モードは GL_NONE にしておく.
+    /// @param width 深度テクスチャの横の画素数.
+    /// @param height 深度テクスチャの縦の画素数.
+    ///
+    /// @note
+    /// 大きさが変わったときはテクスチャを作り直す.
+    /// コンピュートシェーダはイメージユニット 0 と 1 とテクスチャユニット 0 を使う.
+    /// テクスチャユニット 0 の結合と使用中のプログラムオブジェクトは元に戻すが, イメージユニットの結合は解除する.
+    /// 各レベルの大きさは前のレベルの半分を切り捨てたもので, 奇数の端の画素は最後の画素に含める.
+    ///
+    void build(GLuint depth, GLsizei width, GLsizei height);
+
+    ///
+    /// 深度の階層を格納したテクスチャ名を得る.
+    ///
+    /// @return 深度の階層を格納したテクスチャ名, まだ作成していなければ 0.
+    ///
+    GLuint getTexture() const
+    {
+      return texture;
+    }
+
+    ///
+    /// 深度の階層のレベル 0 の横の画素数を得る.
+    ///
+    /// @return レベル 0 の横の画素数.
+    ///
+    GLsizei getWidth() const
+    {
+      return size[0];
+    }
+
+    ///
+    /// 深度の階層のレベル 0 の縦の画素数を得る.
+    ///
+    /// @return レベル 0 の縦の画素数.
+    ///
+    GLsizei getHeight() const
+    {
+      return size[1];
+    }
+
+    ///
+    /// 深度の階層のレベル数を得る.
+    ///
+    /// @return ミップマップのレベル数.
+    ///
+    GLsizei getLevels() const
+    {
+      return levels;
+    }
+  };
+
+  ///
+  /// GPU で可視判定して間接描画する物体の集合.
+  ///
+  /// @note
+  /// 全ての物体は一つの GgElements の頂点インデックスの一部を描画する.
+  /// 物体ごとの変換行列と境界ボックスと描画コマンドをシェーダストレージバッファに置き,
+  /// cull() のコンピュートシェーダで視錐台の外の物体を取り除いて描画コマンドを詰めて書き出す.
+  /// draw() は書き出した描画コマンドを GPU が数えた数だけ glMultiDrawElementsIndirectCountARB() で描画するので,
+  /// 物体の数が増えてもフレームごとの CPU の処理は変わらない.
+  /// GL_ARB_indirect_parameters が使えなければ, 取り除いた物体の instanceCount を 0 にした全ての描画コマンドを描画する.
+  /// 隠面の多い場面では cull() の代わりに二段階の遮蔽判定を行う.
+  /// @code
+  /// scene.cullEarly(mvp);             // 前のフレームで見えていた物体を
+  /// scene.draw();                     // 描画して
+  /// hiz.build(depth, width, height);  // その深度から Hi-Z を作り
+  /// scene.cullLate(mvp, hiz);         // 残りの物体を Hi-Z で判定して
+  /// scene.draw();                     // 新たに見えた物体を描画する
+  /// @endcode
+  /// 描画コマンドの baseInstance には物体の番号が入るので, バーテックスシェーダでは物体のデータを次のように参照する.
+  /// @code
+  /// struct Object { mat4 model; vec4 bmin, bmax; uint count, firstIndex; int baseVertex; uint material; };
+  /// layout (std430, binding = 3) readonly buffer Objects { Object object[]; };
+  /// ... object[gl_BaseInstance].model ...
+  /// @endcode
+  ///
+  class GgIndirectScene
+  {
+  public:
+
+    ///
+    /// シェーダストレージバッファに格納する物体のデータ.
+    ///
+    struct Object
+    {
+      GLfloat model[16];      ///< モデル変換行列.
+      GgVector bmin;          ///< モデル座標系の境界ボックスの最小点.
+      GgVector bmax;          ///< モデル座標系の境界ボックスの最大点.
+      GLuint count;           ///< 描画する頂点インデックスの数.
+      GLuint firstIndex;      ///< 最初の頂点インデックスの位置.
+      GLint baseVertex;       ///< 頂点インデックスに加える値.
+      GLuint material;        ///< 材質番号などシェーダに渡す値.
+    };
+    static_assert(sizeof(Object) == 112, "Object must match the std430 layout.");
+
+  private:
+
+    // 描画する形状
+    std::shared_ptr<GgElements> mesh;
+
+    // 物体のデータ
+    std::vector<Object> object;
+
+    // 物体のデータを格納したシェーダストレージバッファ
+    std::shared_ptr<GgBuffer<Object>> objectBuffer;
+
+    // 可視判定の結果の描画コマンドを格納する間接描画バッファ
+    std::shared_ptr<GgBuffer<GgDrawElementsIndirectCommand>> command;
+
+    // 可視判定で残った描画コマンドの数を格納するバッファ
+    std::shared_ptr<GgBuffer<GLuint>> drawCount;
+
+    // シェーダストレージバッファに転送していない物体の範囲
+    std::size_t dirtyFirst, dirtyLast;
+
+    // 物体ごとの前のフレームの遮蔽判定の結果を格納するバッファ
+    std::shared_ptr<GgBuffer<GLuint>> visibility;
+
+    // 描画コマンドの数を GPU から取り出して描画できるなら true
+    bool indirectCount;
+
+    //
+    // 物体のデータをシェーダストレージバッファに転送する
+    //
+    void update();
+
+    //
+    // 可視判定のコンピュートシェーダを実行する
+    //
+    void dispatch(const GgMatrix& mvp, int phase, const GgHiZ* hiz);
+
+  public:
+
+    ///
+    /// コンストラクタ.
+    ///
+    /// @param mesh 全ての物体が描画する形状.
+    ///
+    GgIndirectScene(const std::shared_ptr<GgElements>& mesh);
+
+    ///
+    /// デストラクタ.
+    ///
+    virtual ~GgIndirectScene()
+    {
+    }
+
+    ///
+    /// 物体を追加する.
+    ///
+    /// @param firstIndex 描画する最初の頂点インデックスの位置.
+    /// @param count 描画する頂点インデックスの数.
+    /// @param bounds モデル座標系の境界ボックス.
+    /// @param model モデル変換行列.
+    /// @param baseVertex 頂点インデックスに加える値.
+    /// @param material 材質番号などシェーダに渡す値.
+    /// @return 追加した物体の番号.
+    ///
+    GLuint add(GLuint firstIndex, GLuint count, const GgBounds& bounds,
+      const GgMatrix& model = ggIdentity(), GLint baseVertex = 0, GLuint material = 0);
+
+    ///
+    /// 物体のモデル変換行列を設定する.
+    ///
+    /// @param i 物体の番号.
+    /// @param model モデル変換行列.
+    ///
+    void setModel(GLuint i, const GgMatrix& model);
+
+    ///
+    /// 物体の数を得る.
+    ///
+    /// @return 追加した物体の数.
+    ///
+    GLsizei getCount() const
+    {
+      return static_cast<GLsizei>(object.size());
+    }
+
+    ///
+    /// 物体のデータを格納したシェーダストレージバッファ名を得る.
+    ///
+    /// @return 物体のデータを格納したシェーダストレージバッファ名, まだ作成していなければ 0.
+    ///
+    GLuint getObjectBuffer() const
+    {
+      return objectBuffer ? objectBuffer->getBuffer() : 0;
+    }
+
+    ///
+    /// 視錐台の外の物体を取り除いて描画コマンドを作る.
+    ///
+    /// @param mvp 投影変換行列とビュー変換行列の積.
+    ///
+    /// @note
+    /// 変更した物体のデータを転送してからコンピュートシェーダで可視判定を行う.
+    /// コンピュートシェーダは shader storage buffer object の結合ポイント 0 から 3 とテクスチャユニット 0 を使うが,
+    /// それらの結合と使用中のプログラムオブジェクトは元に戻すので, 材質などを先に結合しておいてもよい.
+    /// 物体のデータを転送するときにバッファオブジェクトの (インデックスを指定しない) 結合は変わる.
+    ///
+    void cull(const GgMatrix& mvp);
+
+    ///
+    /// 二段階の遮蔽判定の一段目として前のフレームで見えていた物体の描画コマンドを作る.
+    ///
+    /// @param mvp 投影変換行列とビュー変換行列の積.
+    ///
+    /// @note
+    /// 視錐台の中にあって前のフレームの cullLate() で遮蔽されていなかった物体を残す.
+    /// 結合の状態への影響は cull() と同じ.
+    ///
+    void cullEarly(const GgMatrix& mvp);
+
+    ///
+    /// 二段階の遮蔽判定の二段目として Hi-Z で遮蔽されていない物体の描画コマンドを作る.
+    ///
+    /// @param mvp 投影変換行列とビュー変換行列の積.
+    /// @param hiz cullEarly() で残した物体を描画した深度から作成した Hi-Z.
+    ///
+    /// @note
+    /// 視錐台の中の全ての物体の境界ボックスを Hi-Z と比べて次のフレームのための結果を記録し,
+    /// 遮蔽されていない物体のうち cullEarly() で残さなかったものだけを残す.
+    /// 結合の状態への影響は cull() と同じ.
+    ///
+    void cullLate(const GgMatrix& mvp, const GgHiZ& hiz);
+
+    ///
+    /// cull() で残った物体を描画する.
+    ///
+    /// @note
+    /// 物体のデータを SceneObjectBindingPoint に結合して描画するので, シェーダプログラムは先に指定しておく.
+    ///
+    void draw() const;
   };
+#endif
 }
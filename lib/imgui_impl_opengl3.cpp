@@ -207,6 +207,11 @@
 #define IMGUI_IMPL_OPENGL_MAY_HAVE_VTX_OFFSET
 #endif
 
+// Desktop GL 4.4+ has glBufferStorage() for persistently mapped buffers, which GL ES and WebGL don't have.
+#if !defined(IMGUI_IMPL_OPENGL_ES2) && !defined(IMGUI_IMPL_OPENGL_ES3) && defined(GL_VERSION_4_4)
+#define IMGUI_IMPL_OPENGL_MAY_HAVE_BUFFER_STORAGE
+#endif
+
 // Desktop GL 3.3+ and GL ES 3.0+ have glBindSampler()
 #if !defined(IMGUI_IMPL_OPENGL_ES2) && (defined(IMGUI_IMPL_OPENGL_ES3) || defined(GL_VERSION_3_3))
 #define IMGUI_IMPL_OPENGL_MAY_HAVE_BIND_SAMPLER
@@ -221,6 +226,9 @@
 #define GL_CALL(_CALL)      _CALL   // Call without error check
 #endif
 
+// Number of frames the persistently mapped ring buffers can have in flight
+#define IMGUI_IMPL_OPENGL_RING_SEGMENTS 3
+
 // OpenGL Data
 struct ImGui_ImplOpenGL3_Data
 {
@@ -243,6 +251,18 @@ struct ImGui_ImplOpenGL3_Data
     bool            HasPolygonMode;
     bool            HasClipOrigin;
     bool            UseBufferSubData;
+    bool            UsePersistentMapping;    // Stream vertices/indices through persistently mapped ring buffers (GL 4.4+)
+    bool            UseRetainedDrawData;     // Re-issue the previous upload when the draw data did not change
+    ImDrawVert*     RingVtxData;             // Persistently mapped vertex ring
+    ImDrawIdx*      RingIdxData;             // Persistently mapped index ring
+    int             RingVtxCapacity;         // Vertices per segment
+    int             RingIdxCapacity;         // Indices per segment
+    int             RingSegment;             // Segment holding the last upload, -1 if none
+    GLsync          RingFence[IMGUI_IMPL_OPENGL_RING_SEGMENTS];
+    ImVector<int>   RingVtxBase;             // First vertex of each draw list in the ring for the last upload
+    ImVector<int>   RingIdxBase;             // First index of each draw list in the ring for the last upload
+    ImVector<int>   RetainedCounts;          // Vertex/index counts of each draw list for the last upload
+    ImVector<char>  RetainedData;            // Copy of the vertices/indices of the last upload
 
     ImGui_ImplOpenGL3_Data() { memset((void*)this, 0, sizeof(*this)); }
 };
@@ -339,6 +359,10 @@ bool    ImGui_ImplOpenGL3_Init(const char* glsl_version)
 #endif
 
     bd->UseBufferSubData = false;
+    bd->RingSegment = -1;
+#ifdef IMGUI_IMPL_OPENGL_MAY_HAVE_BUFFER_STORAGE
+    bd->UsePersistentMapping = (bd->GlVersion >= 440 && !bd->GlProfileIsES3);
+#endif
     /*
     // Query vendor to enable glBufferSubData kludge
 #ifdef _WIN32
@@ -500,6 +524,133 @@ static void ImGui_ImplOpenGL3_SetupRenderState(ImDrawData* draw_data, int fb_wid
     GL_CALL(glVertexAttribPointer(bd->AttribLocationVtxColor, 4, GL_UNSIGNED_BYTE, GL_TRUE, sizeof(ImDrawVert), (GLvoid*)offsetof(ImDrawVert, col)));
 }
 
+#ifdef IMGUI_IMPL_OPENGL_MAY_HAVE_BUFFER_STORAGE
+// Release the persistently mapped ring buffers (deleting a buffer also unmaps it)
+static void ImGui_ImplOpenGL3_DestroyRingBuffers()
+{
+    ImGui_ImplOpenGL3_Data* bd = ImGui_ImplOpenGL3_GetBackendData();
+    for (GLsync& fence : bd->RingFence)
+        if (fence) { glDeleteSync(fence); fence = nullptr; }
+    if (bd->VboHandle)      { glDeleteBuffers(1, &bd->VboHandle); bd->VboHandle = 0; }
+    if (bd->ElementsHandle) { glDeleteBuffers(1, &bd->ElementsHandle); bd->ElementsHandle = 0; }
+    bd->RingVtxData = nullptr;
+    bd->RingIdxData = nullptr;
+    bd->RingVtxCapacity = bd->RingIdxCapacity = 0;
+    bd->RingSegment = -1;
+    bd->RetainedCounts.clear();
+    bd->RetainedData.clear();
+}
+
+// (Re)create the vertex/index ring buffers with room for IMGUI_IMPL_OPENGL_RING_SEGMENTS frames of the given size.
+// Both buffers are created through GL_ARRAY_BUFFER so that the element buffer binding of the current VAO is left untouched.
+static void ImGui_ImplOpenGL3_CreateRingBuffers(int vtx_capacity, int idx_capacity)
+{
+    ImGui_ImplOpenGL3_Data* bd = ImGui_ImplOpenGL3_GetBackendData();
+    ImGui_ImplOpenGL3_DestroyRingBuffers();
+
+    GLint last_array_buffer; glGetIntegerv(GL_ARRAY_BUFFER_BINDING, &last_array_buffer);
+    const GLbitfield flags = GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT;
+    const GLsizeiptr vtx_size = (GLsizeiptr)vtx_capacity * IMGUI_IMPL_OPENGL_RING_SEGMENTS * (int)sizeof(ImDrawVert);
+    const GLsizeiptr idx_size = (GLsizeiptr)idx_capacity * IMGUI_IMPL_OPENGL_RING_SEGMENTS * (int)sizeof(ImDrawIdx);
+    glGenBuffers(1, &bd->VboHandle);
+    glBindBuffer(GL_ARRAY_BUFFER, bd->VboHandle);
+    glBufferStorage(GL_ARRAY_BUFFER, vtx_size, nullptr, flags);
+    bd->RingVtxData = (ImDrawVert*)glMapBufferRange(GL_ARRAY_BUFFER, 0, vtx_size, flags);
+    glGenBuffers(1, &bd->ElementsHandle);
+    glBindBuffer(GL_ARRAY_BUFFER, bd->ElementsHandle);
+    glBufferStorage(GL_ARRAY_BUFFER, idx_size, nullptr, flags);
+    bd->RingIdxData = (ImDrawIdx*)glMapBufferRange(GL_ARRAY_BUFFER, 0, idx_size, flags);
+    glBindBuffer(GL_ARRAY_BUFFER, (GLuint)last_array_buffer);
+    bd->RingVtxCapacity = vtx_capacity;
+    bd->RingIdxCapacity = idx_capacity;
+}
+
+// Check whether the draw lists hold exactly the vertices/indices of the last upload
+static bool ImGui_ImplOpenGL3_IsRetained(const ImDrawData* draw_data)
+{
+    ImGui_ImplOpenGL3_Data* bd = ImGui_ImplOpenGL3_GetBackendData();
+    if (bd->RingSegment < 0 || bd->RetainedCounts.Size != draw_data->CmdListsCount * 2)
+        return false;
+    const char* retained = bd->RetainedData.Data;
+    for (int n = 0; n < draw_data->CmdListsCount; n++)
+    {
+        const ImDrawList* draw_list = draw_data->CmdLists[n];
+        if (bd->RetainedCounts[n * 2] != draw_list->VtxBuffer.Size || bd->RetainedCounts[n * 2 + 1] != draw_list->IdxBuffer.Size)
+            return false;
+        const size_t vtx_size = (size_t)draw_list->VtxBuffer.Size * sizeof(ImDrawVert);
+        const size_t idx_size = (size_t)draw_list->IdxBuffer.Size * sizeof(ImDrawIdx);
+        if (memcmp(retained, draw_list->VtxBuffer.Data, vtx_size) != 0 || memcmp(retained + vtx_size, draw_list->IdxBuffer.Data, idx_size) != 0)
+            return false;
+        retained += vtx_size + idx_size;
+    }
+    return true;
+}
+
+// Copy all draw lists into the next ring segment, waiting for the GPU if it is still reading that segment
+static void ImGui_ImplOpenGL3_UploadRing(const ImDrawData* draw_data)
+{
+    ImGui_ImplOpenGL3_Data* bd = ImGui_ImplOpenGL3_GetBackendData();
+    if (draw_data->TotalVtxCount > bd->RingVtxCapacity || draw_data->TotalIdxCount > bd->RingIdxCapacity)
+    {
+        const int vtx_capacity = bd->RingVtxCapacity * 2 > draw_data->TotalVtxCount ? bd->RingVtxCapacity * 2 : draw_data->TotalVtxCount;
+        const int idx_capacity = bd->RingIdxCapacity * 2 > draw_data->TotalIdxCount ? bd->RingIdxCapacity * 2 : draw_data->TotalIdxCount;
+        ImGui_ImplOpenGL3_CreateRingBuffers(vtx_capacity, idx_capacity);
+    }
+
+    const int segment = (bd->RingSegment + 1) % IMGUI_IMPL_OPENGL_RING_SEGMENTS;
+    if (GLsync fence = bd->RingFence[segment])
+    {
+        while (glClientWaitSync(fence, GL_SYNC_FLUSH_COMMANDS_BIT, 1000000000) == GL_TIMEOUT_EXPIRED) {}
+        glDeleteSync(fence);
+        bd->RingFence[segment] = nullptr;
+    }
+
+    int vtx_base = segment * bd->RingVtxCapacity;
+    int idx_base = segment * bd->RingIdxCapacity;
+    bd->RingVtxBase.resize(draw_data->CmdListsCount);
+    bd->RingIdxBase.resize(draw_data->CmdListsCount);
+    for (int n = 0; n < draw_data->CmdListsCount; n++)
+    {
+        const ImDrawList* draw_list = draw_data->CmdLists[n];
+        memcpy(bd->RingVtxData + vtx_base, draw_list->VtxBuffer.Data, (size_t)draw_list->VtxBuffer.Size * sizeof(ImDrawVert));
+        memcpy(bd->RingIdxData + idx_base, draw_list->IdxBuffer.Data, (size_t)draw_list->IdxBuffer.Size * sizeof(ImDrawIdx));
+        bd->RingVtxBase[n] = vtx_base;
+        bd->RingIdxBase[n] = idx_base;
+        vtx_base += draw_list->VtxBuffer.Size;
+        idx_base += draw_list->IdxBuffer.Size;
+    }
+    bd->RingSegment = segment;
+
+    // Keep a copy to detect unchanged draw data on the next frames
+    if (bd->UseRetainedDrawData)
+    {
+        bd->RetainedCounts.resize(draw_data->CmdListsCount * 2);
+        bd->RetainedData.resize(draw_data->TotalVtxCount * (int)sizeof(ImDrawVert) + draw_data->TotalIdxCount * (int)sizeof(ImDrawIdx));
+        char* retained = bd->RetainedData.Data;
+        for (int n = 0; n < draw_data->CmdListsCount; n++)
+        {
+            const ImDrawList* draw_list = draw_data->CmdLists[n];
+            const size_t vtx_size = (size_t)draw_list->VtxBuffer.Size * sizeof(ImDrawVert);
+            const size_t idx_size = (size_t)draw_list->IdxBuffer.Size * sizeof(ImDrawIdx);
+            memcpy(retained, draw_list->VtxBuffer.Data, vtx_size);
+            memcpy(retained + vtx_size, draw_list->IdxBuffer.Data, idx_size);
+            retained += vtx_size + idx_size;
+            bd->RetainedCounts[n * 2] = draw_list->VtxBuffer.Size;
+            bd->RetainedCounts[n * 2 + 1] = draw_list->IdxBuffer.Size;
+        }
+    }
+}
+#endif
+
+void    ImGui_ImplOpenGL3_SetRetainedDrawData(bool retained)
+{
+    ImGui_ImplOpenGL3_Data* bd = ImGui_ImplOpenGL3_GetBackendData();
+    IM_ASSERT(bd != nullptr && "Context or backend not initialized! Did you call ImGui_ImplOpenGL3_Init()?");
+    bd->UseRetainedDrawData = retained;
+    bd->RetainedCounts.clear();
+    bd->RetainedData.clear();
+}
+
 // OpenGL3 Render function.
 // Note that this implementation is little overcomplicated because we are saving/setting up/restoring every OpenGL state explicitly.
 // This is in order to be able to run within an OpenGL engine that doesn't do so.
@@ -554,6 +705,13 @@ void    ImGui_ImplOpenGL3_RenderDrawData(ImDrawData* draw_data)
     GLboolean last_enable_primitive_restart = (bd->GlVersion >= 310) ? glIsEnabled(GL_PRIMITIVE_RESTART) : GL_FALSE;
 #endif
 
+#ifdef IMGUI_IMPL_OPENGL_MAY_HAVE_BUFFER_STORAGE
+    // Upload all draw lists into the persistently mapped ring at once, or re-issue the last upload if nothing changed.
+    // This has to happen before the VAO is set up since growing the ring recreates the buffers.
+    if (bd->UsePersistentMapping && !(bd->UseRetainedDrawData && ImGui_ImplOpenGL3_IsRetained(draw_data)))
+        ImGui_ImplOpenGL3_UploadRing(draw_data);
+#endif
+
     // Setup desired GL state
     // Recreate the VAO every time (this is to easily allow multiple GL contexts to be rendered to. VAO are not shared among GL contexts)
     // The renderer would actually work without any VAO bound, but then our VertexAttrib calls would overwrite the default one currently bound.
@@ -580,9 +738,17 @@ void    ImGui_ImplOpenGL3_RenderDrawData(ImDrawData* draw_data)
         // - We are now back to using exclusively glBufferData(). So bd->UseBufferSubData IS ALWAYS FALSE in this code.
         //   We are keeping the old code path for a while in case people finding new issues may want to test the bd->UseBufferSubData path.
         // - See https://github.com/ocornut/imgui/issues/4468 and please report any corruption issues.
+        // - With GL 4.4+ the lists were already copied into the persistently mapped ring above, so only the offsets are needed.
+        GLint vtx_base = 0;
+        GLint idx_base = 0;
         const GLsizeiptr vtx_buffer_size = (GLsizeiptr)draw_list->VtxBuffer.Size * (int)sizeof(ImDrawVert);
         const GLsizeiptr idx_buffer_size = (GLsizeiptr)draw_list->IdxBuffer.Size * (int)sizeof(ImDrawIdx);
-        if (bd->UseBufferSubData)
+        if (bd->UsePersistentMapping)
+        {
+            vtx_base = bd->RingVtxBase[n];
+            idx_base = bd->RingIdxBase[n];
+        }
+        else if (bd->UseBufferSubData)
         {
             if (bd->VertexBufferSize < vtx_buffer_size)
             {
@@ -630,10 +796,11 @@ void    ImGui_ImplOpenGL3_RenderDrawData(ImDrawData* draw_data)
                 GL_CALL(glBindTexture(GL_TEXTURE_2D, (GLuint)(intptr_t)pcmd->GetTexID()));
 #ifdef IMGUI_IMPL_OPENGL_MAY_HAVE_VTX_OFFSET
                 if (bd->GlVersion >= 320)
-                    GL_CALL(glDrawElementsBaseVertex(GL_TRIANGLES, (GLsizei)pcmd->ElemCount, sizeof(ImDrawIdx) == 2 ? GL_UNSIGNED_SHORT : GL_UNSIGNED_INT, (void*)(intptr_t)(pcmd->IdxOffset * sizeof(ImDrawIdx)), (GLint)pcmd->VtxOffset));
+                    GL_CALL(glDrawElementsBaseVertex(GL_TRIANGLES, (GLsizei)pcmd->ElemCount, sizeof(ImDrawIdx) == 2 ? GL_UNSIGNED_SHORT : GL_UNSIGNED_INT, (void*)(intptr_t)((idx_base + pcmd->IdxOffset) * sizeof(ImDrawIdx)), vtx_base + (GLint)pcmd->VtxOffset));
                 else
 #endif
-                GL_CALL(glDrawElements(GL_TRIANGLES, (GLsizei)pcmd->ElemCount, sizeof(ImDrawIdx) == 2 ? GL_UNSIGNED_SHORT : GL_UNSIGNED_INT, (void*)(intptr_t)(pcmd->IdxOffset * sizeof(ImDrawIdx))));
+                GL_CALL(glDrawElements(GL_TRIANGLES, (GLsizei)pcmd->ElemCount, sizeof(ImDrawIdx) == 2 ? GL_UNSIGNED_SHORT : GL_UNSIGNED_INT, (void*)(intptr_t)((idx_base + pcmd->IdxOffset) * sizeof(ImDrawIdx))));
+                IM_UNUSED(vtx_base);
             }
         }
     }
@@ -643,6 +810,16 @@ void    ImGui_ImplOpenGL3_RenderDrawData(ImDrawData* draw_data)
     GL_CALL(glDeleteVertexArrays(1, &vertex_array_object));
 #endif
 
+#ifdef IMGUI_IMPL_OPENGL_MAY_HAVE_BUFFER_STORAGE
+    // Fence the ring segment read by this frame so that it is not overwritten while the GPU still uses it
+    if (bd->UsePersistentMapping && bd->RingSegment >= 0)
+    {
+        if (bd->RingFence[bd->RingSegment])
+            glDeleteSync(bd->RingFence[bd->RingSegment]);
+        bd->RingFence[bd->RingSegment] = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+    }
+#endif
+
     // Restore modified GL state
     // This "glIsProgram()" check is required because if the program is "pending deletion" at the time of binding backup, it will have been deleted by now and will cause an OpenGL error. See #6220.
     if (last_program == 0 || glIsProgram(last_program)) glUseProgram(last_program);
@@ -946,8 +1123,15 @@ bool    ImGui_ImplOpenGL3_CreateDeviceObjects()
     bd->AttribLocationVtxColor = (GLuint)glGetAttribLocation(bd->ShaderHandle, "Color");
 
     // Create buffers
-    glGenBuffers(1, &bd->VboHandle);
-    glGenBuffers(1, &bd->ElementsHandle);
+#ifdef IMGUI_IMPL_OPENGL_MAY_HAVE_BUFFER_STORAGE
+    if (bd->UsePersistentMapping)
+        ImGui_ImplOpenGL3_CreateRingBuffers(1 << 14, 1 << 15);
+    else
+#endif
+    {
+        glGenBuffers(1, &bd->VboHandle);
+        glGenBuffers(1, &bd->ElementsHandle);
+    }
 
     ImGui_ImplOpenGL3_CreateFontsTexture();
 
@@ -967,6 +1151,9 @@ bool    ImGui_ImplOpenGL3_CreateDeviceObjects()
 void    ImGui_ImplOpenGL3_DestroyDeviceObjects()
 {
     ImGui_ImplOpenGL3_Data* bd = ImGui_ImplOpenGL3_GetBackendData();
+#ifdef IMGUI_IMPL_OPENGL_MAY_HAVE_BUFFER_STORAGE
+    ImGui_ImplOpenGL3_DestroyRingBuffers();
+#endif
     if (bd->VboHandle)      { glDeleteBuffers(1, &bd->VboHandle); bd->VboHandle = 0; }
     if (bd->ElementsHandle) { glDeleteBuffers(1, &bd->ElementsHandle); bd->ElementsHandle = 0; }
     if (bd->ShaderHandle)   { glDeleteProgram(bd->ShaderHandle); bd->ShaderHandle = 0; }
@@ -353,14 +353,26 @@ int GgApp::main(int argc, const char* const* argv)
   // メニューの表示
   bool showMenu{ false };
 
+  // プロファイラの表示
+  bool showProfiler{ false };
+
+  // メニューを表示しない間は ImGui のフレームを作らない
+  window.setImGuiVisible(showMenu);
+
+  // 表示間隔を固定するときのフレームレート
+  float fps{ 60.0f };
+
   // ウィンドウが開いている間繰り返す
   while (window)
   {
     // タブキーをタイプしたらメニューを表示する
     showMenu = showMenu || glfwGetKey(window.get(), GLFW_KEY_TAB);
 
-    // メニューを表示するなら
-    if (showMenu)
+    // メニューかプロファイラを表示するなら次のフレームから ImGui のフレームを作る
+    window.setImGuiVisible(showMenu || showProfiler);
+
+    // ImGui のフレームを作っていればメニューを表示する
+    if (showMenu && window.getImGuiFrame())
     {
       // メニューの表示領域を設定する
       ImGui::SetNextWindowPos(ImVec2(2, 2), ImGuiCond_Once);
@@ -431,10 +443,50 @@ int GgApp::main(int argc, const char* const* argv)
         glBindBuffer(GL_UNIFORM_BUFFER, 0);
       }
 
+      //
+      // 表示の設定
+      //
+      ImGui::SeparatorText(u8"表示");
+      auto swapMode{ static_cast<int>(window.getSwapMode()) };
+      if (ImGui::Combo(u8"表示間隔", &swapMode, u8"垂直同期\0制限なし\0固定\0適応垂直同期\0"))
+      {
+        // フレームの表示間隔の制御方法を変更する
+        window.setSwapMode(static_cast<Window::SwapMode>(swapMode), fps);
+      }
+      if (ImGui::DragFloat(u8"フレームレート", &fps, 1.0f, 10.0f, 240.0f) && window.getSwapMode() == Window::Capped)
+      {
+        // フレームレートを変更する
+        window.setSwapMode(Window::Capped, fps);
+      }
+      ImGui::Text(u8"フレーム時間 %.2f ms, 遅延 %.2f ms", window.getFrameTime() * 1000.0, window.getLatency() * 1000.0);
+
+      // フレーム時間のヒストグラム
+      const auto& histogram{ window.getHistogram() };
+      std::array<float, Window::histogramSize> frequency;
+      std::copy(histogram.begin(), histogram.end(), frequency.begin());
+      ImGui::PlotHistogram("##histogram", frequency.data(), static_cast<int>(frequency.size()),
+        0, nullptr, 0.0f, FLT_MAX, ImVec2(0, 64));
+      if (ImGui::Button(u8"ヒストグラムを初期化")) window.resetHistogram();
+      auto idleMode{ window.getIdleMode() };
+      if (ImGui::Checkbox(u8"操作がなければ待機", &idleMode)) window.setIdleMode(idleMode);
+      if (ImGui::Checkbox(u8"プロファイラ", &showProfiler)) Profiler::setEnabled(showProfiler);
+
       // メニューの終了
       ImGui::End();
     }
 
+    // プロファイラのタイムラインを表示する
+    if (showProfiler && window.getImGuiFrame())
+    {
+      Profiler::draw(&showProfiler);
+
+      // タイムラインのウィンドウを閉じたら記録もやめる
+      if (!showProfiler) Profiler::setEnabled(false);
+
+      // タイムラインは毎フレーム更新する
+      window.invalidate();
+    }
+
     // 球のデータのシェーダストレージバッファオブジェクトを 0 番の結合ポイントに結合する
     glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 0, sphereSsbo);
 
@@ -460,8 +512,13 @@ int GgApp::main(int argc, const char* const* argv)
     // texture を image unit に結合する
     glBindImageTexture(ImageUnit, texture, 0, GL_FALSE, 0, GL_WRITE_ONLY, GL_RGBA8);
 
-    // ワークグループを画素ごとに起動する
-    glDispatchCompute(width, height, 1);
+    {
+      // ワークグループを画素ごとに起動する
+      GG_PROFILE_SCOPE("Raycast");
+      GG_PROFILE_GPU_SCOPE("Raycast");
+      ggDebugGroup("Raycast");
+      glDispatchCompute(width, height, 1);
+    }
 
     // シェーダの実行が完了するまで待機する
     glMemoryBarrier(GL_SHADER_IMAGE_ACCESS_BARRIER_BIT);